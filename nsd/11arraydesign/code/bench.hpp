@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+ * Helpers shared by the benchmarks: the best-of-N timing and the checks that
+ * the measured code computes the right thing.  A benchmark stops at the first
+ * failed check, so that a fast but wrong kernel is not reported.
+ */
+
+#include <modmesh/toggle/profile.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+/// Return the best elapsed time in seconds of nrepeat calls to func.
+template <typename F>
+double run(F && func, size_t nrepeat)
+{
+    modmesh::StopWatch sw;
+    double best = 0;
+    for (size_t it=0; it<nrepeat; ++it)
+    {
+        sw.lap();
+        func();
+        double const elapsed = sw.lap();
+        best = (0 == it || elapsed < best) ? elapsed : best;
+    }
+    return best;
+}
+
+/// Exit with failure when cond does not hold.  It is not compiled out like assert().
+inline void check(bool cond, char const * what)
+{
+    if (!cond)
+    {
+        std::cerr << "check failed: " << what << std::endl;
+        std::exit(1);
+    }
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,126 @@
+/*
+ * Time saving a Laplace grid to an .npy file and reading it back: loaded into
+ * memory, mapped without copying, and read a chunk of rows at a time.  The
+ * header is checked to round trip before the timing, and every way of
+ * reading is checked to give back the saved grid.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+void check_header(modmesh::small_vector<size_t> const & shape, bool fortran_order, size_t nghost)
+{
+    modmesh::ArrayFileHeader header;
+    header.descr = modmesh::ArrayFileHeader::make_descr<double>();
+    header.fortran_order = fortran_order;
+    header.shape = shape;
+    header.nghost = nghost;
+    std::string const text = header.format();
+    check(0 == header.offset % modmesh::ARRAY_FILE_ALIGN, "ArrayFile: payload offset is not aligned");
+    check(text.size() == header.offset && '\n' == text.back(), "ArrayFile: header does not end at the offset");
+
+    std::istringstream is(text);
+    modmesh::ArrayFileHeader const back = modmesh::ArrayFileHeader::read(is, "header");
+    check(back.descr == header.descr, "ArrayFile: descr after round trip");
+    check(back.fortran_order == fortran_order, "ArrayFile: fortran_order after round trip");
+    check(back.shape == shape, "ArrayFile: shape after round trip");
+    check(back.nghost == nghost, "ArrayFile: nghost after round trip");
+    check(back.offset == header.offset, "ArrayFile: offset after round trip");
+}
+
+bool same_grid(modmesh::SimpleArray<double> const & arr, modmesh::SimpleArray<double> const & ref)
+{
+    if (!(arr.shape() == ref.shape()) || arr.nghost() != ref.nghost())
+    {
+        return false;
+    }
+    for (size_t i=0; i<ref.shape(0); ++i)
+    {
+        for (size_t j=0; j<ref.shape(1); ++j)
+        {
+            if (arr.data(i * arr.stride(0) + j * arr.stride(1)) != ref.data(i * ref.stride(0) + j * ref.stride(1)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nx = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+    std::string const path = argc > 2 ? argv[2] : "bench_arrayfile.npy";
+    constexpr size_t nrepeat = 5;
+
+    check_header(modmesh::small_vector<size_t>{5}, false, 0);
+    check_header(modmesh::small_vector<size_t>{3, 4}, true, 0);
+    check_header(modmesh::small_vector<size_t>{7, 3, 4}, false, 2);
+    check_header(modmesh::small_vector<size_t>{0, 4}, false, 0);
+
+    // The initial grid of solve1(): a sine on one boundary and zero elsewhere.
+    modmesh::SimpleArray<double> grid(std::vector<size_t>{nx, nx}, 0.0);
+    for (size_t it=0; it<nx; ++it)
+    {
+        grid(0, it) = std::sin(static_cast<double>(it) / static_cast<double>(nx) * M_PI);
+    }
+    grid.set_nghost(1);
+    double const mbytes = static_cast<double>(grid.nbytes()) / (1 << 20);
+    std::cout << "grid " << nx << "x" << nx << " double: " << mbytes << " MB" << std::endl;
+
+    double const t_save = run([&]() { modmesh::save_array(path, grid); }, nrepeat);
+    std::cout << "  save: " << t_save << " sec (" << mbytes / t_save << " MB/s)" << std::endl;
+
+    modmesh::SimpleArray<double> loaded;
+    double const t_load = run([&]() { loaded = modmesh::load_array<double>(path); }, nrepeat);
+    std::cout << "  load: " << t_load << " sec (" << mbytes / t_load << " MB/s)" << std::endl;
+    check(same_grid(loaded, grid), "ArrayFile: loaded array differs from the saved one");
+
+    double sum = 0;
+    double const t_map = run(
+        [&]()
+        {
+            modmesh::SimpleArray<double> const mapped = modmesh::map_array<double>(path);
+            sum = 0;
+            for (size_t it=0; it<mapped.size(); ++it)
+            {
+                sum += mapped[it];
+            }
+        },
+        nrepeat);
+    std::cout << "  map and sum: " << t_map << " sec (" << sum << ")" << std::endl;
+    check(same_grid(modmesh::map_array<double>(path), grid), "ArrayFile: mapped array differs from the saved one");
+
+    double const t_reader = run(
+        [&]()
+        {
+            modmesh::ArrayFileReader<double> reader(path);
+            size_t const nrow = reader.default_chunk();
+            for (size_t row=0; !reader.eof(); row+=nrow)
+            {
+                modmesh::SimpleArray<double> const chunk = reader.read(nrow);
+                check(chunk.data(0) == grid.data(row * nx), "ArrayFile: chunk of rows differs from the saved one");
+            }
+        },
+        nrepeat);
+    std::cout << "  read by rows: " << t_reader << " sec" << std::endl;
+
+    // A Fortran-ordered array keeps its order through the file.
+    modmesh::SimpleArray<double> const fgrid = grid.to_layout(modmesh::ArrayLayout::F);
+    modmesh::save_array(path, fgrid);
+    modmesh::SimpleArray<double> const floaded = modmesh::load_array<double>(path);
+    check(floaded.is_f_contiguous() && same_grid(floaded, grid), "ArrayFile: Fortran-ordered round trip");
+
+    std::remove(path.c_str());
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
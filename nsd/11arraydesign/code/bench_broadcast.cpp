@@ -0,0 +1,58 @@
+/*
+ * Add a row and a column to a grid with broadcasting, which reads the vector
+ * in place with the stride 0, against adding a grid materialized from the
+ * vector first.  Report the time and the extra memory of each way.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using array_type = modmesh::SimpleArray<double>;
+
+void compare(std::string const & name, array_type const & grid, array_type const & vec, size_t nrepeat)
+{
+    array_type out(grid.shape());
+    double const t_broadcast = run([&]() { out = grid + vec; }, nrepeat);
+    double const checksum = out(grid.shape(0) - 1, grid.shape(1) - 1);
+
+    array_type full;
+    double const t_materialize = run(
+        [&]()
+        {
+            full = array_type(grid.shape());
+            modmesh::broadcast_assign(full, vec);
+            out = grid + full;
+        },
+        nrepeat);
+    bool const same = checksum == out(grid.shape(0) - 1, grid.shape(1) - 1);
+
+    std::cout << "  " << name << " broadcast: " << t_broadcast << " sec, " << vec.nbytes() << " bytes read in place" << std::endl;
+    std::cout << "  " << name << " materialized: " << t_materialize << " sec, " << full.nbytes() << " extra bytes"
+              << (same ? "" : " (MISMATCH)") << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nx = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    constexpr size_t nrepeat = 5;
+    array_type grid(std::vector<size_t>{nx, nx}, 1.0);
+    array_type row(std::vector<size_t>{nx});
+    array_type col(std::vector<size_t>{nx, 1});
+    for (size_t it=0; it<nx; ++it)
+    {
+        row[it] = static_cast<double>(it);
+        col[it] = static_cast<double>(nx - it);
+    }
+
+    std::cout << "grid " << nx << "x" << nx << " double" << std::endl;
+    compare("row", grid, row, nrepeat);
+    compare("column", grid, col, nrepeat);
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,76 @@
+/*
+ * Measure the compression of a Laplace grid in ChunkedArray: the ratio, the
+ * time to compress from and decompress to SimpleArray, and the element access
+ * through the chunk cache against SimpleArray.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char ** argv)
+{
+    size_t const nx = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+    constexpr size_t nrepeat = 5;
+    // The initial grid of solve1(): a sine on one boundary and zero elsewhere.
+    modmesh::SimpleArray<double> grid(std::vector<size_t>{nx, nx}, 0.0);
+    for (size_t it=0; it<nx; ++it)
+    {
+        grid(0, it) = std::sin(static_cast<double>(it) / static_cast<double>(nx) * M_PI);
+    }
+
+    modmesh::ChunkedArray<double> chunked(grid);
+    double const t_compress = run([&]() { chunked = modmesh::ChunkedArray<double>(grid); }, nrepeat);
+    std::cout << "grid " << nx << "x" << nx << " double: " << chunked.raw_nbytes() << " bytes in "
+              << chunked.nbytes() << " compressed bytes (" << chunked.nchunk() << " chunks)" << std::endl;
+    std::cout << "  compress: " << t_compress << " sec" << std::endl;
+    modmesh::SimpleArray<double> back;
+    double const t_decompress = run([&]() { back = chunked.to_simple(); }, nrepeat);
+    std::cout << "  decompress: " << t_decompress << " sec" << std::endl;
+    // The run-length codec is lossless.
+    check(back.shape() == grid.shape(), "ChunkedArray: shape after round trip");
+    for (size_t it=0; it<nx*nx; ++it)
+    {
+        check(back[it] == grid[it], "ChunkedArray: element after round trip");
+    }
+
+    double sum = 0;
+    double const t_simple = run(
+        [&]()
+        {
+            sum = 0;
+            for (size_t it=0; it<nx; ++it)
+            {
+                for (size_t jt=0; jt<nx; ++jt)
+                {
+                    sum += grid(it, jt);
+                }
+            }
+        },
+        nrepeat);
+    std::cout << "  row sweep SimpleArray: " << t_simple << " sec (" << sum << ")" << std::endl;
+    double const sum_simple = sum;
+    double const t_chunked = run(
+        [&]()
+        {
+            sum = 0;
+            for (size_t it=0; it<nx; ++it)
+            {
+                for (size_t jt=0; jt<nx; ++jt)
+                {
+                    sum += chunked(it, jt);
+                }
+            }
+        },
+        nrepeat);
+    std::cout << "  row sweep ChunkedArray: " << t_chunked << " sec (" << sum << ", "
+              << chunked.miss_count() << " cache misses)" << std::endl;
+    check(sum == sum_simple, "ChunkedArray: row sweep differs from SimpleArray");
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,56 @@
+/*
+ * Measure building an array of unknown length element by element: a
+ * std::vector copied into a SimpleArray at the end, against SimpleCollector
+ * handing its storage to the SimpleArray, with and without the mremap()
+ * growth.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char ** argv)
+{
+    size_t const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 26);
+    constexpr size_t nrepeat = 5;
+    std::cout << "append " << n << " doubles" << std::endl;
+    modmesh::SimpleArray<double> arr;
+
+    double const t_vector = run(
+        [&]()
+        {
+            std::vector<double> vec;
+            for (size_t it=0; it<n; ++it) { vec.push_back(static_cast<double>(it)); }
+            arr = modmesh::SimpleArray<double>(vec.begin(), vec.end());
+        },
+        nrepeat);
+    std::cout << "  std::vector and copy: " << t_vector << " sec (" << arr[n - 1] << ")" << std::endl;
+
+    double const t_collector = run(
+        [&]()
+        {
+            modmesh::SimpleCollector<double> col;
+            for (size_t it=0; it<n; ++it) { col.push_back(static_cast<double>(it)); }
+            arr = col.as_array();
+        },
+        nrepeat);
+    std::cout << "  SimpleCollector: " << t_collector << " sec (" << arr[n - 1] << ")" << std::endl;
+
+    // Reserve the final length up front so that nothing is grown.
+    double const t_reserved = run(
+        [&]()
+        {
+            modmesh::SimpleCollector<double> col(n);
+            for (size_t it=0; it<n; ++it) { col.push_back(static_cast<double>(it)); }
+            arr = col.as_array();
+        },
+        nrepeat);
+    std::cout << "  SimpleCollector reserved: " << t_reserved << " sec (" << arr[n - 1] << ")" << std::endl;
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,71 @@
+/*
+ * Compare the Jacobi update of the Laplace solver written as a hand loop, as
+ * a fused array expression on slice views, and as one temporary array per
+ * operation like NumPy does.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using array_type = modmesh::SimpleArray<double>;
+using modmesh::SimpleSlice;
+
+void update_loop(array_type const & u, array_type & un)
+{
+    size_t const nx = u.shape(0);
+    for (size_t it=1; it<nx-1; ++it)
+    {
+        for (size_t jt=1; jt<nx-1; ++jt)
+        {
+            un(it-1,jt-1) = (u(it+1,jt) + u(it-1,jt) + u(it,jt+1) + u(it,jt-1)) * 0.25;
+        }
+    }
+}
+
+void update_expression(array_type const & u, array_type & un)
+{
+    size_t const nx = u.shape(0);
+    array_type const u_n = u.view({SimpleSlice{2, nx}, SimpleSlice{1, nx-1}});
+    array_type const u_s = u.view({SimpleSlice{0, nx-2}, SimpleSlice{1, nx-1}});
+    array_type const u_e = u.view({SimpleSlice{1, nx-1}, SimpleSlice{2, nx}});
+    array_type const u_w = u.view({SimpleSlice{1, nx-1}, SimpleSlice{0, nx-2}});
+    un = (u_n + u_s + u_e + u_w) * 0.25;
+}
+
+void update_temporary(array_type const & u, array_type & un)
+{
+    size_t const nx = u.shape(0);
+    array_type const u_n = u.view({SimpleSlice{2, nx}, SimpleSlice{1, nx-1}});
+    array_type const u_s = u.view({SimpleSlice{0, nx-2}, SimpleSlice{1, nx-1}});
+    array_type const u_e = u.view({SimpleSlice{1, nx-1}, SimpleSlice{2, nx}});
+    array_type const u_w = u.view({SimpleSlice{1, nx-1}, SimpleSlice{0, nx-2}});
+    // Materialize every intermediate result.
+    array_type t1 = u_n + u_s;
+    array_type t2 = t1 + u_e;
+    array_type t3 = t2 + u_w;
+    un = t3 * 0.25;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nx = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    constexpr size_t nrepeat = 5;
+    array_type u(std::vector<size_t>{nx, nx});
+    for (size_t it=0; it<nx*nx; ++it) { u[it] = static_cast<double>(it % 17); }
+    array_type un(std::vector<size_t>{nx-2, nx-2});
+
+    double const t_loop = run([&]() { update_loop(u, un); }, nrepeat);
+    double const t_expr = run([&]() { update_expression(u, un); }, nrepeat);
+    double const t_temp = run([&]() { update_temporary(u, un); }, nrepeat);
+    std::cout
+        << "Jacobi update " << nx << "x" << nx << ": loop " << t_loop << " sec, expression " << t_expr
+        << " sec, temporaries " << t_temp << " sec" << std::endl;
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
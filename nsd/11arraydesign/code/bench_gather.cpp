@@ -0,0 +1,69 @@
+/*
+ * Measure take, put and scatter_add with random indices, as a cell-to-node
+ * connectivity of an unstructured mesh: the scalar against the AVX2 gather,
+ * and the threaded paths against one thread.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+template <typename I>
+void bench(size_t nnode, size_t nindex, size_t nrepeat)
+{
+    std::mt19937_64 rng(42);
+    modmesh::SimpleArray<double> node(std::vector<size_t>{nnode});
+    for (size_t it=0; it<nnode; ++it)
+    {
+        node[it] = static_cast<double>(it);
+    }
+    modmesh::SimpleArray<I> idx(std::vector<size_t>{nindex});
+    for (size_t it=0; it<nindex; ++it)
+    {
+        idx[it] = static_cast<I>(rng() % nnode);
+    }
+    modmesh::SimpleArray<double> out(std::vector<size_t>{nindex});
+
+    std::cout << "nnode " << nnode << ", nindex " << nindex << ", index " << sizeof(I) * 8 << "-bit" << std::endl;
+    modmesh::SimdDispatch & dispatch = modmesh::SimdDispatch::me();
+    modmesh::SimdLevel const detected = dispatch.detected();
+    modmesh::GatherScatterOptions serial;
+    serial.nthread = 1;
+    for (modmesh::SimdLevel const level : {modmesh::SimdLevel::SCALAR, detected})
+    {
+        dispatch.set_level(level);
+        double const t_take = run([&]() { modmesh::take(node, idx, out, serial); }, nrepeat);
+        std::cout << "  take " << modmesh::SimdDispatch::name(level) << ": " << t_take << " sec" << std::endl;
+    }
+    dispatch.set_level(detected);
+
+    size_t const nmax = std::max(std::thread::hardware_concurrency(), 1U);
+    for (size_t nthread=1; nthread<=std::max(nmax, size_t(4)); nthread*=2)
+    {
+        modmesh::GatherScatterOptions options;
+        options.nthread = nthread;
+        double const t_take = run([&]() { modmesh::take(node, idx, out, options); }, nrepeat);
+        modmesh::SimpleArray<double> dst(std::vector<size_t>{nnode}, 0.0);
+        double const t_put = run([&]() { modmesh::put(dst, idx, out, options); }, nrepeat);
+        double const t_add = run([&]() { modmesh::scatter_add(dst, idx, out, options); }, nrepeat);
+        std::cout << "  " << nthread << " threads: take " << t_take << " sec, put " << t_put
+                  << " sec, scatter_add " << t_add << " sec" << std::endl;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nnode = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    size_t const nindex = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1 << 24;
+    constexpr size_t nrepeat = 5;
+    bench<int32_t>(nnode, nindex, nrepeat);
+    bench<int64_t>(nnode, nindex, nrepeat);
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,114 @@
+/*
+ * Compare the Jacobi sweeps of solve1() in solve_cpp.cpp on the whole grid
+ * with the same sweeps on the blocks of DomainDecomposition, a thread per
+ * block with the halo exchanged between the sweeps.  Both run a fixed number
+ * of steps and must produce the same grid.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using array_type = modmesh::SimpleArray<double>;
+
+array_type solve_serial(array_type u, size_t nstep)
+{
+    size_t const nx = u.shape(0);
+    array_type un = u;
+    for (size_t step=0; step<nstep; ++step)
+    {
+        for (size_t it=1; it<nx-1; ++it)
+        {
+            for (size_t jt=1; jt<nx-1; ++jt)
+            {
+                un(it,jt) = (u(it+1,jt) + u(it-1,jt) + u(it,jt+1) + u(it,jt-1)) / 4;
+            }
+        }
+        u.swap(un);
+    }
+    return u;
+}
+
+array_type solve_blocks(array_type const & uin, size_t nstep, size_t npart0, size_t npart1)
+{
+    size_t const nx = uin.shape(0);
+    modmesh::DomainDecomposition const dd(uin.shape(), modmesh::small_vector<size_t>{npart0, npart1});
+    std::vector<array_type> u = dd.scatter(uin);
+    std::vector<array_type> un = dd.scatter(uin);
+    auto sweep = [&](size_t ib)
+    {
+        array_type & ub = u[ib];
+        array_type & unb = un[ib];
+        // Skip the boundary of the grid; the body starts at column 1 of a block.
+        ssize_t const ibegin = 0 == dd.offset(ib, 0) ? 1 : 0;
+        ssize_t const iend = dd.offset(ib, 0) + dd.extent(ib, 0) == nx ? dd.extent(ib, 0) - 1 : dd.extent(ib, 0);
+        size_t const jbegin = 0 == dd.offset(ib, 1) ? 2 : 1;
+        size_t const jend = dd.offset(ib, 1) + dd.extent(ib, 1) == nx ? dd.extent(ib, 1) : dd.extent(ib, 1) + 1;
+        for (ssize_t it=ibegin; it<iend; ++it)
+        {
+            for (size_t jt=jbegin; jt<jend; ++jt)
+            {
+                unb(it,jt) = (ub(it+1,jt) + ub(it-1,jt) + ub(it,jt+1) + ub(it,jt-1)) / 4;
+            }
+        }
+        ub.swap(unb);
+        return 1.0;
+    };
+    dd.iterate(u, sweep, /* tolerance */ 0.0, nstep);
+    array_type ret(uin.shape());
+    dd.gather(u, ret);
+    return ret;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nx = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    size_t const nstep = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    constexpr size_t nrepeat = 3;
+    array_type uin(std::vector<size_t>{nx, nx}, 0.0);
+    for (size_t it=0; it<nx; ++it)
+    {
+        uin(0, it) = std::sin(static_cast<double>(it) / static_cast<double>(nx) * M_PI);
+    }
+
+    array_type ref;
+    double const t_serial = run([&]() { ref = solve_serial(uin, nstep); }, nrepeat);
+    std::cout << "jacobi " << nx << "x" << nx << ", " << nstep << " steps" << std::endl;
+    std::cout << "  whole grid: " << t_serial << " sec" << std::endl;
+    size_t const nmax = std::max(std::thread::hardware_concurrency(), 1U);
+    for (size_t nthread=1; nthread<=std::max(nmax, size_t(4)); nthread*=2)
+    {
+        // Rows only, and the most square cut into nthread blocks.
+        size_t npart1 = 1;
+        for (size_t it=1; it*it<=nthread; ++it)
+        {
+            npart1 = 0 == nthread % it ? it : npart1;
+        }
+        for (size_t const np1 : {size_t(1), npart1})
+        {
+            array_type ret;
+            double const t_blocks = run([&]() { ret = solve_blocks(uin, nstep, nthread / np1, np1); }, nrepeat);
+            bool same = true;
+            for (size_t it=0; it<nx*nx; ++it)
+            {
+                same = same && ret[it] == ref[it];
+            }
+            std::cout
+                << "  " << nthread / np1 << "x" << np1 << " blocks: " << t_blocks << " sec"
+                << (same ? "" : " (MISMATCH)") << std::endl;
+            if (1 == npart1)
+            {
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,76 @@
+/*
+ * Repeat the skip-access pattern of nsd/05cache/code/01_skip_access.cpp over
+ * SimpleArray on normal and on huge pages.  With a stride of 1024 ints every
+ * access is on a new 4 KB page and misses the TLB, but 512 of them share a
+ * 2 MB page.  The kilobytes of AnonHugePages in /proc/self/smaps_rollup tell
+ * whether the system granted the huge pages.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+size_t anon_huge_kb()
+{
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string key;
+    size_t value = 0;
+    while (smaps >> key)
+    {
+        if ("AnonHugePages:" == key)
+        {
+            smaps >> value;
+            return value;
+        }
+    }
+    return 0;
+}
+
+void bench(char const * name, modmesh::SimpleArray<int> & arr, size_t nrepeat)
+{
+    size_t const nelem = arr.size();
+    int * data = arr.data();
+    for (size_t i=0; i<nelem; ++i) { data[i] = static_cast<int>(i); }
+    std::cout << name << " (alignment " << static_cast<size_t>(arr.buffer().alignment())
+              << ", AnonHugePages " << anon_huge_kb() << " kB):" << std::endl;
+    for (size_t skip : {1, 16, 64, 256, 1024, 4096})
+    {
+        double const elapsed = run(
+            [&]()
+            {
+                for (size_t i=0; i<nelem; i+=skip) { data[i] *= 3; }
+            },
+            nrepeat);
+        std::cout << "  skipping " << skip << ": " << elapsed << " sec ("
+                  << elapsed / static_cast<double>(nelem / skip) * 1e9 << " ns per access)" << std::endl;
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nelem = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 128 * 1024 * 1024;
+    constexpr size_t nrepeat = 5;
+    modmesh::SimpleArray<int>::shape_type const shape{nelem};
+    {
+        modmesh::SimpleArray<int> arr(shape);
+        bench("normal pages", arr, nrepeat);
+    }
+    {
+        modmesh::SimpleArray<int> arr(shape, modmesh::BufferAlignment::HUGEPAGE);
+        bench("huge pages", arr, nrepeat);
+    }
+    {
+        modmesh::BufferHugePage::me().set_threshold(64 * 1024 * 1024);
+        modmesh::SimpleArray<int> arr(shape);
+        bench("huge pages by threshold", arr, nrepeat);
+        modmesh::BufferHugePage::me().set_threshold(0);
+    }
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,94 @@
+/*
+ * Measure the bandwidth of a threaded triad a = b + s * c over arrays whose
+ * pages are placed by a serial fill, by the parallel first touch with the
+ * static partition of the triad, and by interleaving over the NUMA nodes.
+ * The difference shows only on a machine of more than one node.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+#include <modmesh/toggle/profile.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void triad(
+    modmesh::SimpleArray<double> & a
+  , modmesh::SimpleArray<double> const & b
+  , modmesh::SimpleArray<double> const & c
+  , double s
+  , size_t nthread)
+{
+    size_t const n = a.size();
+    auto work = [&](size_t ithread)
+    {
+        for (size_t it=n*ithread/nthread; it<n*(ithread+1)/nthread; ++it)
+        {
+            a[it] = b[it] + s * c[it];
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t it=1; it<nthread; ++it)
+    {
+        threads.emplace_back(work, it);
+    }
+    work(0);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+}
+
+template <typename M>
+void bench(char const * name, M && make, size_t n, size_t nthread, size_t nrepeat)
+{
+    modmesh::StopWatch sw;
+    sw.lap();
+    modmesh::SimpleArray<double> a = make(0.0);
+    modmesh::SimpleArray<double> b = make(1.0);
+    modmesh::SimpleArray<double> c = make(2.0);
+    double const t_alloc = sw.lap();
+    double const t_triad = run([&]() { triad(a, b, c, 3.0, nthread); }, nrepeat);
+    double const gbyte = 3.0 * static_cast<double>(n * sizeof(double)) / 1e9;
+    std::cout << "  " << name << ": allocate " << t_alloc << " sec, triad " << t_triad << " sec ("
+              << gbyte / t_triad << " GB/s, a[n-1] = " << a[n - 1] << ")" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (size_t(1) << 25);
+    size_t const nthread = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                    : std::max(std::thread::hardware_concurrency(), 1U);
+    constexpr size_t nrepeat = 5;
+    std::string nodes;
+    std::ifstream("/sys/devices/system/node/online") >> nodes;
+    std::cout << "triad of " << n << " doubles, " << nthread << " threads, NUMA nodes "
+              << (nodes.empty() ? "unknown" : nodes) << std::endl;
+
+    modmesh::SimpleArray<double>::shape_type const shape{n};
+    bench(
+        "serial fill",
+        [&](double v) { return modmesh::SimpleArray<double>(shape, v); },
+        n, nthread, nrepeat);
+    modmesh::BufferNumaOptions touch;
+    touch.nthread = nthread;
+    bench(
+        "first touch",
+        [&](double v) { return modmesh::SimpleArray<double>(shape, v, touch); },
+        n, nthread, nrepeat);
+    modmesh::BufferNumaOptions interleave;
+    interleave.policy = modmesh::BufferNumaPolicy::INTERLEAVE;
+    interleave.nthread = nthread;
+    bench(
+        "interleave",
+        [&](double v) { return modmesh::SimpleArray<double>(shape, v, interleave); },
+        n, nthread, nrepeat);
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
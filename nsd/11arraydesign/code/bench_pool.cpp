@@ -0,0 +1,122 @@
+/*
+ * Measure the allocation savings of BufferPool on the Laplace solver.  The
+ * Jacobi iteration is written in the way that allocates the next solution in
+ * every step, like the NumPy version in 02_solve_array.py.  The allocations
+ * are counted per run and checked against the hits and misses of the pool
+ * over all the runs.
+ *
+ * The saving is the cost of the allocation itself, so it shows where the
+ * allocation is a large part of the work: the 1024x1024 grid, whose fresh
+ * pages fault on first touch without the pool, and the tiny fitting
+ * temporaries.  For 51x51 the stencil dominates and the two are even.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+modmesh::SimpleArray<double> make_grid(size_t nx)
+{
+    modmesh::SimpleArray<double> u(std::vector<size_t>{nx, nx}, 0.0);
+    for (size_t it=0; it<nx; ++it)
+    {
+        u(nx-1, it) = std::sin(M_PI * it / (nx-1));
+    }
+    return u;
+}
+
+size_t solve_alloc(modmesh::SimpleArray<double> const & u0, size_t nstep)
+{
+    const size_t nx = u0.shape(0);
+    modmesh::SimpleArray<double> u = u0;
+    size_t nalloc = 1;
+    for (size_t step=0; step<nstep; ++step)
+    {
+        // The copy allocates.
+        modmesh::SimpleArray<double> un = u;
+        ++nalloc;
+        for (size_t it=1; it<nx-1; ++it)
+        {
+            for (size_t jt=1; jt<nx-1; ++jt)
+            {
+                un(it,jt) = (u(it+1,jt) + u(it-1,jt) + u(it,jt+1) + u(it,jt-1)) / 4;
+            }
+        }
+        u = std::move(un);
+    }
+    return nalloc;
+}
+
+size_t fit_temporaries(size_t ninterval, size_t order)
+{
+    // The temporaries allocated for each interval in fit_polys().
+    size_t nalloc = 0;
+    for (size_t it=0; it<ninterval; ++it)
+    {
+        modmesh::SimpleArray<double> matrix(std::vector<size_t>{order+1, order+1}, 1.0);
+        modmesh::SimpleArray<double> rhs(std::vector<size_t>{order+1}, 1.0);
+        modmesh::SimpleArray<double> mat = matrix;
+        modmesh::SimpleArray<double> b = rhs;
+        modmesh::SimpleArray<int> ipiv(order+1);
+        nalloc += 5;
+    }
+    return nalloc;
+}
+
+/// Report the best time of a run and the allocations of all the nrepeat runs.
+void report(char const * name, bool enabled, double elapsed, size_t nalloc, size_t nrepeat)
+{
+    modmesh::BufferPool & pool = modmesh::BufferPool::me();
+    std::cout
+        << name << (enabled ? " with pool" : " without pool") << ": "
+        << elapsed << " sec, " << nalloc << " allocations per run";
+    if (enabled)
+    {
+        size_t const nhit = pool.hit_count();
+        size_t const nmiss = pool.miss_count();
+        check(nhit + nmiss == nalloc * nrepeat, "BufferPool: hits and misses do not add up to the allocations");
+        std::cout << " (" << nrepeat << " runs, hit: " << nhit << ", miss: " << nmiss << ")";
+    }
+    std::cout << std::endl;
+}
+
+int main(int, char **)
+{
+    modmesh::BufferPool & pool = modmesh::BufferPool::me();
+    constexpr size_t nrepeat = 5;
+
+    for (size_t nx : {51, 256, 1024})
+    {
+        size_t const nstep = 256 * 256 * 64 / (nx * nx) + 1;
+        modmesh::SimpleArray<double> const u = make_grid(nx);
+        std::cout << "Laplace " << nx << "x" << nx << ", " << nstep << " steps" << std::endl;
+        for (bool enabled : {false, true})
+        {
+            if (enabled) { pool.enable(); } else { pool.disable(); }
+            pool.reset_count();
+            size_t nalloc = 0;
+            double const elapsed = run([&]() { nalloc = solve_alloc(u, nstep); }, nrepeat);
+            report("  solve", enabled, elapsed, nalloc, nrepeat);
+        }
+        pool.trim();
+    }
+
+    std::cout << "Fitting temporaries, 100000 intervals" << std::endl;
+    for (bool enabled : {false, true})
+    {
+        if (enabled) { pool.enable(); } else { pool.disable(); }
+        pool.reset_count();
+        size_t nalloc = 0;
+        double const elapsed = run([&]() { nalloc = fit_temporaries(100000, 3); }, nrepeat);
+        report("  fit", enabled, elapsed, nalloc, nrepeat);
+    }
+    pool.trim();
+
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,74 @@
+/*
+ * Compare the serial scalar loop of calc_norm_amax() in solve_cpp.cpp with
+ * the threaded SIMD reductions, and the plain and the deterministic sums.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+template <typename T>
+T calc_norm_amax_loop(modmesh::SimpleArray<T> const & arr0, modmesh::SimpleArray<T> const & arr1)
+{
+    size_t const nelm = arr0.size();
+    T ret = 0;
+    for (size_t it = 0; it < nelm; ++it)
+    {
+        T const val = std::abs(arr0[it] - arr1[it]);
+        if (val > ret)
+        {
+            ret = val;
+        }
+    }
+    return ret;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nelem = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+    constexpr size_t nrepeat = 5;
+    modmesh::SimpleArray<double> a(nelem), b(nelem);
+    for (size_t it=0; it<nelem; ++it)
+    {
+        a[it] = std::sin(it * 1.e-3);
+        b[it] = a[it] + 1.e-6 * std::cos(it * 1.e-2);
+    }
+
+    double norm = 0;
+    double const t_loop = run([&]() { norm = calc_norm_amax_loop(a, b); }, nrepeat);
+    std::cout << "diff amax, " << nelem << " elements" << std::endl;
+    std::cout << "  serial loop: " << t_loop << " sec (" << norm << ")" << std::endl;
+    size_t const nmax = std::max(std::thread::hardware_concurrency(), 1U);
+    for (size_t nthread=1; nthread<=nmax; nthread*=2)
+    {
+        modmesh::ReduceOptions options;
+        options.nthread = nthread;
+        double const t_reduce = run([&]() { norm = modmesh::reduce::diff_amax(a, b, options); }, nrepeat);
+        std::cout << "  reduce " << nthread << " thread(s): " << t_reduce << " sec (" << norm << ")" << std::endl;
+    }
+
+    std::cout << "sum, " << nelem << " elements" << std::endl;
+    for (bool deterministic : {false, true})
+    {
+        for (size_t nthread=1; nthread<=nmax; nthread*=2)
+        {
+            modmesh::ReduceOptions options;
+            options.nthread = nthread;
+            options.deterministic = deterministic;
+            double sum = 0;
+            double const t_sum = run([&]() { sum = modmesh::reduce::sum(a, options); }, nrepeat);
+            std::cout
+                << "  " << (deterministic ? "deterministic " : "") << nthread << " thread(s): "
+                << t_sum << " sec (" << std::setprecision(17) << sum << std::setprecision(6) << ")" << std::endl;
+        }
+    }
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
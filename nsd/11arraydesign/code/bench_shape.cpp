@@ -0,0 +1,93 @@
+/*
+ * Time the shape and stride handling of SimpleArray from 1 to 6 dimensions:
+ * reshape, view and at() of a small array, where the cost is in building the
+ * small_vector of the shape, stride and index rather than in the data.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/// Check small_vector across the inline capacity, where it moves to the heap.
+void check_small_vector()
+{
+    using vector_type = modmesh::small_vector<size_t, 3>;
+    vector_type vec;
+    for (size_t it=0; it<10; ++it)
+    {
+        vec.push_back(it * 3);
+        check(it + 1 == vec.size(), "small_vector: size after push_back");
+        check(it < 3 ? 3 == vec.capacity() : it < vec.capacity(), "small_vector: capacity after push_back");
+    }
+    for (size_t it=0; it<10; ++it)
+    {
+        check(it * 3 == vec[it], "small_vector: element after growth");
+    }
+    vector_type copy(vec);
+    check(copy == vec, "small_vector: copy");
+    vector_type moved(std::move(copy));
+    check(moved == vec && copy.empty(), "small_vector: move");
+    moved.resize(2);
+    check(2 == moved.size() && 3 == moved[1], "small_vector: resize down");
+    vector_type small{4, 5};
+    moved = small;
+    check(moved == small && std::vector<size_t>(moved.begin(), moved.end()) == std::vector<size_t>{4, 5},
+          "small_vector: assign from inline");
+}
+
+int main(int argc, char ** argv)
+{
+    check_small_vector();
+    size_t const niter = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    constexpr size_t nrepeat = 5;
+    using array_type = modmesh::SimpleArray<double>;
+    for (size_t ndim=1; ndim<=6; ++ndim)
+    {
+        std::vector<size_t> shape(ndim, 2);
+        array_type arr(shape, 1.0);
+        std::vector<size_t> flat(ndim, 1);
+        flat[0] = arr.size();
+        std::vector<size_t> idx(ndim, 1);
+        check(arr.reshape(array_type::shape_type(flat)).shape() == array_type::shape_type(flat), "reshape: shape");
+        check(1 == arr.view(0, 0, 1).shape(0) && ndim == arr.view(0, 0, 1).ndim(), "view: shape");
+        check(1.0 == arr.at(idx), "at: value");
+        double sum = 0;
+        double const t_reshape = run(
+            [&]()
+            {
+                for (size_t it=0; it<niter; ++it)
+                {
+                    sum += arr.reshape(array_type::shape_type(flat)).shape(0);
+                }
+            },
+            nrepeat);
+        double const t_view = run(
+            [&]()
+            {
+                for (size_t it=0; it<niter; ++it)
+                {
+                    sum += arr.view(0, 0, 1).shape(0);
+                }
+            },
+            nrepeat);
+        double const t_at = run(
+            [&]()
+            {
+                for (size_t it=0; it<niter; ++it)
+                {
+                    sum += arr.at(idx);
+                }
+            },
+            nrepeat);
+        std::cout << ndim << "-D: reshape " << t_reshape / niter * 1e9 << " ns, view " << t_view / niter * 1e9
+                  << " ns, at " << t_at / niter * 1e9 << " ns (" << sum << ")" << std::endl;
+    }
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,83 @@
+/*
+ * Time the SIMD kernels at each instruction-set level available on this CPU
+ * against the scalar kernels, and verify the results.  The default length is
+ * not a multiple of any vector width so that the masked tails are exercised,
+ * and small enough for the data to stay in cache.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+
+template <typename T>
+bool close(T lhs, T rhs)
+{
+    return std::abs(lhs - rhs) <= 1.e-4 * std::abs(rhs) + 1.e-6;
+}
+
+template <typename T>
+void bench(char const * tname, size_t nelem, size_t nloop)
+{
+    using array_type = modmesh::SimpleArray<T>;
+    modmesh::SimdDispatch & dispatch = modmesh::SimdDispatch::me();
+    constexpr size_t nrepeat = 5;
+
+    // Scale the integer data so that it is not all zeros.
+    double const scale = std::is_integral_v<T> ? 100.0 : 1.0;
+    array_type a(nelem), b(nelem), c(nelem), out(nelem), ref(nelem);
+    for (size_t it=0; it<nelem; ++it)
+    {
+        a[it] = static_cast<T>(scale * std::sin(it * 0.1));
+        b[it] = static_cast<T>(scale * std::cos(it * 0.1));
+        c[it] = static_cast<T>(it % 7);
+    }
+
+    dispatch.set_level(modmesh::SimdLevel::SCALAR);
+    modmesh::simd::fma(a, b, c, ref);
+    T const ref_sum = modmesh::simd::sum(a);
+    T const ref_amax = modmesh::simd::amax(a);
+
+    std::cout << tname << " x " << nelem << ", " << nloop << " loops" << std::endl;
+    for (int level=0; level<=static_cast<int>(dispatch.detected()); ++level)
+    {
+        dispatch.set_level(static_cast<modmesh::SimdLevel>(level));
+        double const t_add = run([&]() { for (size_t it=0; it<nloop; ++it) { modmesh::simd::add(a, b, out); } }, nrepeat);
+        double const t_fma = run([&]() { for (size_t it=0; it<nloop; ++it) { modmesh::simd::fma(a, b, c, out); } }, nrepeat);
+        T sum = 0;
+        T amax = 0;
+        double const t_sum = run([&]() { for (size_t it=0; it<nloop; ++it) { sum = modmesh::simd::sum(a); } }, nrepeat);
+        double const t_amax = run([&]() { for (size_t it=0; it<nloop; ++it) { amax = modmesh::simd::amax(a); } }, nrepeat);
+
+        size_t nwrong = 0;
+        for (size_t it=0; it<nelem; ++it)
+        {
+            nwrong += close(out[it], ref[it]) ? 0 : 1;
+        }
+        nwrong += close(sum, ref_sum) ? 0 : 1;
+        nwrong += amax == ref_amax ? 0 : 1;
+
+        std::cout
+            << "  " << modmesh::SimdDispatch::name(static_cast<modmesh::SimdLevel>(level))
+            << ": add " << t_add << " sec, fma " << t_fma << " sec, sum " << t_sum
+            << " sec, amax " << t_amax << " sec, wrong: " << nwrong << std::endl;
+    }
+    dispatch.set_level(dispatch.detected());
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nelem = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4099;
+    size_t const nloop = 400000000 / nelem + 1;
+    bench<float>("float", nelem, nloop);
+    bench<double>("double", nelem, nloop);
+    bench<int16_t>("int16", nelem, nloop);
+    bench<int8_t>("int8", nelem, nloop);
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
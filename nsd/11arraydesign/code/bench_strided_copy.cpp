@@ -0,0 +1,102 @@
+/*
+ * Compare the recursive copy that TypeBroadcast used to do with the
+ * non-recursive strided_copy() engine.  copy_idx() below is the old
+ * TypeBroadcastImpl::copy_idx() with the pybind11 input replaced by a
+ * pointer and element strides: it recomputes both offsets over all the
+ * dimensions for every element, writes through the range-checked
+ * SimpleArray::at(), and calls itself once per element.
+ *
+ * strided_copy() is timed with the conversion kernels at the detected SIMD
+ * level and with SimdDispatch lowered to the scalar loop.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// NOLINTNEXTLINE(misc-no-recursion)
+template <typename D, typename S>
+void copy_idx(
+    modmesh::SimpleArray<D> & arr_out, S const * data_in, modmesh::small_vector<ssize_t> const & stride_in,
+    modmesh::small_vector<size_t> const & left_shape, modmesh::small_vector<size_t> sidx, int dim)
+{
+    if (dim < 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < left_shape[dim]; ++i)
+    {
+        sidx[dim] = i;
+        ssize_t offset_in = 0;
+        for (size_t it = 0; it < left_shape.size(); ++it)
+        {
+            offset_in += stride_in[it] * static_cast<ssize_t>(sidx[it]);
+        }
+        size_t offset_out = 0;
+        for (size_t it = 0; it < arr_out.ndim(); ++it)
+        {
+            offset_out += arr_out.stride(it) * sidx[it];
+        }
+        arr_out.at(offset_out) = static_cast<D>(data_in[offset_in]);
+        copy_idx(arr_out, data_in, stride_in, left_shape, sidx, dim - 1);
+    }
+}
+
+template <typename D, typename S>
+void compare(char const * name, modmesh::small_vector<size_t> const & shape)
+{
+    constexpr size_t nrepeat = 3;
+    modmesh::small_vector<ssize_t> stride(shape.size());
+    ssize_t n = 1;
+    for (size_t it = shape.size(); it > 0; --it)
+    {
+        stride[it - 1] = n;
+        n *= static_cast<ssize_t>(shape[it - 1]);
+    }
+    modmesh::SimpleArray<S> src(static_cast<size_t>(n));
+    for (ssize_t it = 0; it < n; ++it) { src[it] = static_cast<S>(it % 127); }
+    modmesh::SimpleArray<D> dst(shape);
+    modmesh::SimpleArray<D> const & cdst = dst;
+    modmesh::SimdDispatch & dispatch = modmesh::SimdDispatch::me();
+
+    double const t_rec = run(
+        [&]()
+        {
+            copy_idx(dst, src.data(), stride, shape, modmesh::small_vector<size_t>(shape.size(), 0),
+                     static_cast<int>(shape.size()) - 1);
+        },
+        nrepeat);
+    check(cdst.data()[n - 1] == static_cast<D>((n - 1) % 127), "copy_idx: wrong last element");
+    dispatch.set_level(modmesh::SimdLevel::SCALAR);
+    double const t_scalar = run([&]() { modmesh::strided_copy(dst.data(), stride, src.data(), stride, shape); }, nrepeat);
+    dispatch.set_level(dispatch.detected());
+    double const t_simd = run([&]() { modmesh::strided_copy(dst.data(), stride, src.data(), stride, shape); }, nrepeat);
+    check(cdst.data()[n - 1] == static_cast<D>((n - 1) % 127), "strided_copy: wrong last element");
+
+    std::cout << name << " ";
+    for (size_t it = 0; it < shape.size(); ++it) { std::cout << (it ? "x" : "") << shape[it]; }
+    std::cout
+        << ": recursive " << t_rec << " sec, strided_copy scalar " << t_scalar << " sec, "
+        << modmesh::SimdDispatch::name(dispatch.level()) << " " << t_simd << " sec ("
+        << t_rec / t_simd << "x)" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const nelem = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    std::vector<modmesh::small_vector<size_t>> const shapes{{nelem}, {nelem / 1000, 1000}, {nelem / 4, 4}};
+    for (auto const & shape : shapes)
+    {
+        compare<double, double>("double <- double", shape);
+        compare<double, int32_t>("double <- int32 ", shape);
+        compare<double, float>("double <- float ", shape);
+        compare<float, double>("float  <- double", shape);
+    }
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -0,0 +1,104 @@
+/*
+ * Compare the naive double loop that transposes a matrix, as in solve() of
+ * data_prep.cpp, with the tiled SIMD transpose, threaded and in place.
+ */
+
+#include <modmesh/buffer/buffer.hpp>
+
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+template <typename T>
+modmesh::SimpleArray<T> transpose_loop(modmesh::SimpleArray<T> const & sarr)
+{
+    modmesh::SimpleArray<T> mat(std::vector<size_t>{sarr.shape(1), sarr.shape(0)});
+    for (size_t i = 0; i < mat.shape(0); ++i)
+    {
+        for (size_t j = 0; j < mat.shape(1); ++j)
+        {
+            mat(i, j) = sarr(j, i);
+        }
+    }
+    return mat;
+}
+
+int main(int argc, char ** argv)
+{
+    size_t const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    constexpr size_t nrepeat = 5;
+    modmesh::SimpleArray<double> a(std::vector<size_t>{n, n});
+    for (size_t it=0; it<n*n; ++it)
+    {
+        a[it] = static_cast<double>(it);
+    }
+
+    modmesh::SimpleArray<double> const ref = transpose_loop(a);
+    // The tiled kernels must agree with the naive loop to the bit.
+    auto same = [&](modmesh::SimpleArray<double> const & arr)
+    {
+        if (!(arr.shape() == ref.shape()))
+        {
+            return false;
+        }
+        for (size_t i=0; i<n; ++i)
+        {
+            for (size_t j=0; j<n; ++j)
+            {
+                if (arr(i, j) != ref(i, j))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    modmesh::SimpleArray<double> b;
+    double const t_loop = run([&]() { b = transpose_loop(a); }, nrepeat);
+    std::cout << "transpose " << n << "x" << n << " double" << std::endl;
+    std::cout << "  naive loop: " << t_loop << " sec (" << b(n - 1, 0) << ")" << std::endl;
+    size_t const nmax = std::max(std::thread::hardware_concurrency(), 1U);
+    for (size_t nthread=1; nthread<=nmax; nthread*=2)
+    {
+        modmesh::TransposeOptions options;
+        options.nthread = nthread;
+        double const t_tiled = run([&]() { b = modmesh::transpose(a, options); }, nrepeat);
+        check(same(b), "transpose: result differs from the naive loop");
+        std::cout << "  tiled " << nthread << " thread(s): " << t_tiled << " sec (" << b(n - 1, 0) << ")" << std::endl;
+    }
+    modmesh::transpose_inplace(a);
+    check(same(a), "transpose_inplace: result differs from the naive loop");
+    modmesh::transpose_inplace(a);
+    // Transpose twice in place to keep the content unchanged between runs.
+    double const t_inplace = run([&]() { modmesh::transpose_inplace(a); modmesh::transpose_inplace(a); }, nrepeat);
+    std::cout << "  in place: " << t_inplace / 2 << " sec (" << a(0, n - 1) << ")" << std::endl;
+    for (size_t it=0; it<n*n; ++it)
+    {
+        check(static_cast<double>(it) == a[it], "transpose_inplace: twice is not the identity");
+    }
+
+    modmesh::SimpleArray<double> c(std::vector<size_t>{64, n / 8, n / 8});
+    for (size_t it=0; it<c.size(); ++it)
+    {
+        c[it] = static_cast<double>(it);
+    }
+    modmesh::SimpleArray<double> d;
+    double const t_permute = run([&]() { d = modmesh::permute(c, modmesh::small_vector<size_t>{2, 0, 1}); }, nrepeat);
+    for (size_t i=0; i<d.shape(0); ++i)
+    {
+        for (size_t j=0; j<d.shape(1); ++j)
+        {
+            for (size_t k=0; k<d.shape(2); ++k)
+            {
+                check(d(i, j, k) == c(j, k, i), "permute: element moved to the wrong place");
+            }
+        }
+    }
+    std::cout << "permute (2, 0, 1) of 64x" << n / 8 << "x" << n / 8 << " double: " << t_permute << " sec" << std::endl;
+    return 0;
+}
+
+// vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -18,6 +18,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <utility>
 
 namespace modmesh
 {
@@ -44,30 +45,27 @@ void import_numpy()
 
 modmesh::SimpleArray<double> solve
 (
-    modmesh::SimpleArray<double> const & sarr
-  , modmesh::SimpleArray<double> const & rhs
+    modmesh::SimpleArray<double> mat
+  , modmesh::SimpleArray<double> b
 )
 {
-    // Populate the column major input by transposing
-    modmesh::SimpleArray<double> mat(
-        std::vector<size_t>{sarr.shape(1), sarr.shape(0)});
-    for (size_t i = 0; i < mat.shape(0); ++i)
+    // LAPACK takes the column major (Fortran) order, and dgesv_ overwrites
+    // the matrix with its factors and the right-hand side with the solution.
+    // Both arguments are taken by value for that, and the matrix is copied
+    // only when it is not already in Fortran order.
+    if (!mat.is_f_contiguous())
     {
-        for (size_t j = 0; j < mat.shape(1); ++j)
-        {
-            mat(i, j) = sarr(j, i);
-        }
+        mat = mat.to_layout(modmesh::ArrayLayout::F);
     }
 
-    modmesh::SimpleArray<double> b = rhs;
-    int n = rhs.size();
+    int n = b.size();
     modmesh::SimpleArray<int> ipiv(n);
 
     int status;
     int nn = mat.shape(0);
     int bncol = 1;
     int bnrow = b.shape(0);
-    int matnrow = mat.shape(1);
+    int matnrow = mat.shape(0);
 
     // FIXME: This call is not yet validated. I am not sure about the
     // correctness of the solution.
@@ -105,7 +103,7 @@ modmesh::SimpleArray<double> fit_poly
     }
 
     // The rank of the linear map is (order+1).
-    modmesh::SimpleArray<double> matrix(std::vector<size_t>{order+1, order+1});
+    modmesh::SimpleArray<double> matrix(std::vector<size_t>{order+1, order+1}, modmesh::ArrayLayout::F);
 
     // Use the x coordinates to build the linear map for least-square
     // regression.
@@ -135,7 +133,7 @@ modmesh::SimpleArray<double> fit_poly
     }
 
     // Solve the linear system for the least-square minimization.
-    modmesh::SimpleArray<double> lhs = solve(matrix, rhs);
+    modmesh::SimpleArray<double> lhs = solve(std::move(matrix), std::move(rhs));
     std::reverse(lhs.begin(), lhs.end()); // to make numpy.poly1d happy.
 
     return lhs;
@@ -210,8 +208,8 @@ PYBIND11_MODULE(data_prep, m)
           , size_t order
         )
         {
-            auto xarr = modmesh::python::makeSimpleArray(xarr_in);
-            auto yarr = modmesh::python::makeSimpleArray(yarr_in);
+            auto xarr = modmesh::python::makeContiguousSimpleArray(xarr_in);
+            auto yarr = modmesh::python::makeContiguousSimpleArray(yarr_in);
             auto ret = fit_poly(xarr, yarr, 0, xarr.size(), order);
             return modmesh::python::to_ndarray(ret);
         }
@@ -226,8 +224,8 @@ PYBIND11_MODULE(data_prep, m)
           , size_t order
         )
         {
-            auto xarr = modmesh::python::makeSimpleArray(xarr_in);
-            auto yarr = modmesh::python::makeSimpleArray(yarr_in);
+            auto xarr = modmesh::python::makeContiguousSimpleArray(xarr_in);
+            auto yarr = modmesh::python::makeContiguousSimpleArray(yarr_in);
             auto ret = fit_polys(xarr, yarr, order);
             return modmesh::python::to_ndarray(ret);
         }
@@ -0,0 +1,543 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+#include <modmesh/buffer/Broadcast.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace modmesh
+{
+
+/**
+ * Base of the lazy elementwise expressions on SimpleArray.  Arithmetic
+ * operators, comparisons and the unary math functions below build a tree of
+ * light-weight nodes that refers to the operand arrays without copying them.
+ * Nothing is computed until the tree is assigned to a SimpleArray, and then
+ * all the operations are done in one fused pass over the destination:
+ *
+ *   un = (u_n + u_s + u_e + u_w) * 0.25;
+ *
+ * The leaves hold the buffers of the operand arrays, so that an expression
+ * may outlive them, e.g., a temporary operand.  The destination must not
+ * overlap an operand at a different offset.  The array operands follow
+ * the NumPy broadcasting rules, e.g., a row (n) or a column (m, 1) applies to
+ * every row or column of a grid (m, n), and is read in place with the stride
+ * 0 instead of being expanded.  A scalar operand applies to every element.
+ */
+template <typename E>
+class ArrayExpression
+{
+
+public:
+
+    E const & derived() const { return static_cast<E const &>(*this); }
+    E & derived() { return static_cast<E &>(*this); }
+
+}; /* end class ArrayExpression */
+
+template <typename S>
+using is_array_expression = std::is_base_of<ArrayExpression<std::remove_cv_t<std::remove_reference_t<S>>>, std::remove_cv_t<std::remove_reference_t<S>>>;
+
+template <typename S>
+inline constexpr bool is_array_expression_v = is_array_expression<S>::value;
+
+namespace detail
+{
+
+/**
+ * Leaf node reading a SimpleArray row by row.  It keeps the buffer of the
+ * array alive, and the geometry as it was when the leaf was made.
+ */
+template <typename T>
+class ArrayLeaf
+    : public ArrayExpression<ArrayLeaf<T>>
+{
+
+public:
+
+    using value_type = T;
+    using shape_type = typename SimpleArray<T>::shape_type;
+
+    static constexpr bool is_scalar = false;
+
+    explicit ArrayLeaf(SimpleArray<T> const & array)
+        : m_buffer(array ? array.buffer().shared_from_this() : nullptr)
+        , m_data(array ? array.data() : nullptr)
+        , m_shape(array.shape())
+        , m_stride(array.stride())
+        , m_c_contiguous(array.is_c_contiguous())
+    {
+    }
+
+    /// Shape of the operand itself, before broadcast().
+    shape_type const & shape() const { return m_shape; }
+    bool is_c_contiguous() const { return !m_broadcast && m_c_contiguous; }
+    bool is_unit_inner() const
+    {
+        size_t const last = m_stride.size() - 1;
+        return (!m_broadcast && 1 == m_shape[last]) || 1 == m_stride[last];
+    }
+
+    /// Read the operand as the destination shape, with the stride 0 along the stretched dimensions.
+    template <typename S>
+    void broadcast(S const & shape)
+    {
+        if (!(shape == m_shape))
+        {
+            m_stride = broadcast_stride(m_shape, m_stride, shape);
+            m_broadcast = true;
+        }
+    }
+
+    /// Point to the row at the outer index (all dimensions but the last).
+    template <typename S>
+    void seek(S const & outer)
+    {
+        value_type const * row = m_data;
+        for (size_t it = 0; it < outer.size(); ++it)
+        {
+            row += outer[it] * m_stride[it];
+        }
+        m_row = row;
+        m_inner = m_stride[m_stride.size() - 1];
+    }
+
+    /// Point to the whole C-contiguous array as a single row.
+    void seek_flat()
+    {
+        m_row = m_data;
+        m_inner = 1;
+    }
+
+    value_type operator[](size_t it) const { return m_row[it]; }
+    value_type at(size_t it) const { return m_row[it * m_inner]; }
+
+private:
+
+    std::shared_ptr<ConcreteBuffer const> m_buffer;
+    value_type const * m_data;
+    shape_type m_shape;
+    shape_type m_stride;
+    bool m_c_contiguous;
+    bool m_broadcast = false;
+    value_type const * m_row = nullptr;
+    size_t m_inner = 1;
+
+}; /* end class ArrayLeaf */
+
+/// Leaf node of a scalar applied to every element.
+template <typename T>
+class ArrayScalar
+    : public ArrayExpression<ArrayScalar<T>>
+{
+
+public:
+
+    using value_type = T;
+    using shape_type = small_vector<size_t>;
+
+    static constexpr bool is_scalar = true;
+
+    explicit ArrayScalar(value_type value)
+        : m_value(value)
+    {
+    }
+
+    bool is_c_contiguous() const { return true; }
+    bool is_unit_inner() const { return true; }
+    template <typename S>
+    void broadcast(S const &)
+    {
+    }
+    template <typename S>
+    void seek(S const &)
+    {
+    }
+    void seek_flat() {}
+
+    value_type operator[](size_t) const { return m_value; }
+    value_type at(size_t) const { return m_value; }
+
+private:
+
+    value_type m_value;
+
+}; /* end class ArrayScalar */
+
+template <typename Op, typename A>
+class ArrayUnary
+    : public ArrayExpression<ArrayUnary<Op, A>>
+{
+
+public:
+
+    using value_type = decltype(Op{}(std::declval<typename A::value_type>()));
+    using shape_type = typename A::shape_type;
+
+    static constexpr bool is_scalar = A::is_scalar;
+
+    explicit ArrayUnary(A const & arg)
+        : m_arg(arg)
+    {
+    }
+
+    shape_type const & shape() const { return m_arg.shape(); }
+    bool is_c_contiguous() const { return m_arg.is_c_contiguous(); }
+    bool is_unit_inner() const { return m_arg.is_unit_inner(); }
+    template <typename S>
+    void broadcast(S const & shape)
+    {
+        m_arg.broadcast(shape);
+    }
+    template <typename S>
+    void seek(S const & outer)
+    {
+        m_arg.seek(outer);
+    }
+    void seek_flat() { m_arg.seek_flat(); }
+
+    value_type operator[](size_t it) const { return Op{}(m_arg[it]); }
+    value_type at(size_t it) const { return Op{}(m_arg.at(it)); }
+
+private:
+
+    A m_arg;
+
+}; /* end class ArrayUnary */
+
+template <typename Op, typename L, typename R>
+class ArrayBinary
+    : public ArrayExpression<ArrayBinary<Op, L, R>>
+{
+
+public:
+
+    using value_type = decltype(Op{}(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()));
+    using shape_type = typename std::conditional_t<L::is_scalar, R, L>::shape_type;
+
+    static constexpr bool is_scalar = L::is_scalar && R::is_scalar;
+
+    ArrayBinary(L const & lhs, R const & rhs)
+        : m_lhs(lhs)
+        , m_rhs(rhs)
+    {
+        if constexpr (!L::is_scalar && !R::is_scalar)
+        {
+            if (!detail::try_broadcast_shape(lhs.shape(), rhs.shape(), m_shape))
+            {
+                std::ostringstream ms;
+                ms << "ArrayExpression: operand shape mismatch: ";
+                print_broadcast_shape(ms, lhs.shape());
+                ms << " vs ";
+                print_broadcast_shape(ms, rhs.shape());
+                throw std::runtime_error(ms.str());
+            }
+        }
+        else if constexpr (L::is_scalar && !R::is_scalar)
+        {
+            m_shape = rhs.shape();
+        }
+        else if constexpr (!L::is_scalar)
+        {
+            m_shape = lhs.shape();
+        }
+    }
+
+    /// Broadcast shape of the operands.
+    shape_type const & shape() const { return m_shape; }
+
+    bool is_c_contiguous() const { return m_lhs.is_c_contiguous() && m_rhs.is_c_contiguous(); }
+    bool is_unit_inner() const { return m_lhs.is_unit_inner() && m_rhs.is_unit_inner(); }
+
+    template <typename S>
+    void broadcast(S const & shape)
+    {
+        m_lhs.broadcast(shape);
+        m_rhs.broadcast(shape);
+    }
+
+    template <typename S>
+    void seek(S const & outer)
+    {
+        m_lhs.seek(outer);
+        m_rhs.seek(outer);
+    }
+
+    void seek_flat()
+    {
+        m_lhs.seek_flat();
+        m_rhs.seek_flat();
+    }
+
+    value_type operator[](size_t it) const { return Op{}(m_lhs[it], m_rhs[it]); }
+    value_type at(size_t it) const { return Op{}(m_lhs.at(it), m_rhs.at(it)); }
+
+private:
+
+    L m_lhs;
+    R m_rhs;
+    shape_type m_shape;
+
+}; /* end class ArrayBinary */
+
+template <typename S>
+struct is_array_operand : std::false_type
+{
+}; /* end struct is_array_operand */
+
+template <typename T>
+struct is_array_operand<SimpleArray<T>> : std::true_type
+{
+}; /* end struct is_array_operand */
+
+template <typename S>
+inline constexpr bool is_array_operand_v = is_array_operand<std::remove_cv_t<std::remove_reference_t<S>>>::value || is_array_expression_v<S>;
+
+template <typename S>
+inline constexpr bool is_expression_operand_v = is_array_operand_v<S> || std::is_arithmetic_v<std::remove_reference_t<S>>;
+
+template <typename L, typename R>
+inline constexpr bool is_expression_pair_v = is_expression_operand_v<L> && is_expression_operand_v<R> && !(std::is_arithmetic_v<L> && std::is_arithmetic_v<R>);
+
+/// Turn an operand into an expression node.
+template <typename S>
+auto make_node(S const & operand)
+{
+    if constexpr (is_array_operand<S>::value)
+    {
+        return ArrayLeaf<typename S::value_type>(operand);
+    }
+    else if constexpr (is_array_expression_v<S>)
+    {
+        return operand;
+    }
+    else
+    {
+        return ArrayScalar<S>(operand);
+    }
+}
+
+template <typename Op, typename L, typename R>
+auto make_binary(L const & lhs, R const & rhs)
+{
+    using lnode_type = decltype(make_node(lhs));
+    using rnode_type = decltype(make_node(rhs));
+    return ArrayBinary<Op, lnode_type, rnode_type>(make_node(lhs), make_node(rhs));
+}
+
+template <typename Op, typename A>
+auto make_unary(A const & arg)
+{
+    return ArrayUnary<Op, decltype(make_node(arg))>(make_node(arg));
+}
+
+} /* end namespace detail */
+
+// clang-format off
+#define MM_DECL_ARRAY_BINARY(OP, FUNCTOR) \
+template <typename L, typename R, typename = std::enable_if_t<detail::is_expression_pair_v<L, R>>> \
+auto operator OP(L const & lhs, R const & rhs) { return detail::make_binary<FUNCTOR>(lhs, rhs); }
+
+MM_DECL_ARRAY_BINARY(+, std::plus<>)
+MM_DECL_ARRAY_BINARY(-, std::minus<>)
+MM_DECL_ARRAY_BINARY(*, std::multiplies<>)
+MM_DECL_ARRAY_BINARY(/, std::divides<>)
+MM_DECL_ARRAY_BINARY(==, std::equal_to<>)
+MM_DECL_ARRAY_BINARY(!=, std::not_equal_to<>)
+MM_DECL_ARRAY_BINARY(<, std::less<>)
+MM_DECL_ARRAY_BINARY(<=, std::less_equal<>)
+MM_DECL_ARRAY_BINARY(>, std::greater<>)
+MM_DECL_ARRAY_BINARY(>=, std::greater_equal<>)
+
+#undef MM_DECL_ARRAY_BINARY
+
+#define MM_DECL_ARRAY_UNARY_MATH(NAME) \
+namespace detail \
+{ \
+struct NAME##_functor \
+{ \
+    template <typename A> \
+    auto operator()(A a) const { return std::NAME(a); } \
+}; \
+} /* end namespace detail */ \
+template <typename A, typename = std::enable_if_t<detail::is_array_operand_v<A>>> \
+auto NAME(A const & arg) { return detail::make_unary<detail::NAME##_functor>(arg); }
+
+MM_DECL_ARRAY_UNARY_MATH(abs)
+MM_DECL_ARRAY_UNARY_MATH(sqrt)
+MM_DECL_ARRAY_UNARY_MATH(exp)
+MM_DECL_ARRAY_UNARY_MATH(log)
+MM_DECL_ARRAY_UNARY_MATH(sin)
+MM_DECL_ARRAY_UNARY_MATH(cos)
+
+#undef MM_DECL_ARRAY_UNARY_MATH
+// clang-format on
+
+template <typename A, typename = std::enable_if_t<detail::is_array_operand_v<A>>>
+auto operator-(A const & arg) { return detail::make_unary<std::negate<>>(arg); }
+
+/**
+ * Evaluate the expression into the destination array in one pass.  The
+ * expression is broadcast to the destination shape.  When both sides are
+ * C-contiguous the whole array is a single loop; otherwise the outer
+ * dimensions are walked row by row and the last one is the inner loop.
+ */
+template <typename T, typename E>
+void assign_expression(SimpleArray<T> & dst, ArrayExpression<E> const & expr)
+{
+    E node = expr.derived(); // seek() moves the row pointers of the copy.
+    if (!is_broadcastable(node.shape(), dst.shape()))
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: cannot broadcast array expression of shape ";
+        detail::print_broadcast_shape(ms, node.shape());
+        ms << " to ";
+        detail::print_broadcast_shape(ms, dst.shape());
+        throw std::runtime_error(ms.str());
+    }
+    node.broadcast(dst.shape());
+
+    if (0 == dst.ndim())
+    {
+        // A 0-d array has no row to walk.  It holds a single element when it
+        // views a buffer, and none when it was made from the empty shape.
+        if (dst)
+        {
+            T * out = dst.data();
+            node.seek_flat();
+            out[0] = static_cast<T>(node[0]);
+        }
+        return;
+    }
+
+    T * out = dst.data(); // Detach copy-on-write before reading the operands.
+    if (dst.is_c_contiguous() && node.is_c_contiguous())
+    {
+        node.seek_flat();
+        size_t length = 1;
+        for (size_t it = 0; it < dst.ndim(); ++it)
+        {
+            length *= dst.shape(it);
+        }
+        for (size_t it = 0; it < length; ++it)
+        {
+            out[it] = static_cast<T>(node[it]);
+        }
+        return;
+    }
+
+    size_t const last = dst.ndim() - 1;
+    size_t const length = dst.shape(last);
+    size_t const dstride = dst.stride(last);
+    bool const unit = 1 == dstride && node.is_unit_inner();
+    for (size_t it = 0; it <= last; ++it)
+    {
+        if (0 == dst.shape(it))
+        {
+            return;
+        }
+    }
+    typename SimpleArray<T>::shape_type outer(last, 0);
+    while (true)
+    {
+        node.seek(outer);
+        T * row = out;
+        for (size_t it = 0; it < last; ++it)
+        {
+            row += outer[it] * dst.stride(it);
+        }
+        if (unit)
+        {
+            for (size_t it = 0; it < length; ++it)
+            {
+                row[it] = static_cast<T>(node[it]);
+            }
+        }
+        else
+        {
+            for (size_t it = 0; it < length; ++it)
+            {
+                row[it * dstride] = static_cast<T>(node.at(it));
+            }
+        }
+
+        size_t dim = last;
+        while (dim > 0)
+        {
+            --dim;
+            if (++outer[dim] < dst.shape(dim))
+            {
+                break;
+            }
+            outer[dim] = 0;
+            if (0 == dim)
+            {
+                return;
+            }
+        }
+        if (0 == last)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * Copy the source array into the destination array with broadcasting, e.g.,
+ * fill every row of a grid with a row vector.  The source is read in place.
+ */
+template <typename T, typename U>
+void broadcast_assign(SimpleArray<T> & dst, SimpleArray<U> const & src)
+{
+    small_vector<ssize_t> dst_stride(dst.ndim());
+    for (size_t it = 0; it < dst.ndim(); ++it)
+    {
+        dst_stride[it] = static_cast<ssize_t>(dst.stride(it));
+    }
+    small_vector<ssize_t> src_stride(src.ndim());
+    for (size_t it = 0; it < src.ndim(); ++it)
+    {
+        src_stride[it] = static_cast<ssize_t>(src.stride(it));
+    }
+    src_stride = broadcast_stride(src.shape(), src_stride, dst.shape());
+    T * out = dst.data(); // Detach copy-on-write before reading the source.
+    strided_copy(out, dst_stride, src.data(), src_stride, dst.shape());
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,496 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Save and load SimpleArray in the NumPy .npy format.
+ *
+ * The header records the dtype, the shape, and the memory order (C or
+ * Fortran), which determines the strides.  The payload starts at a multiple
+ * of 64 bytes, so that an array mapped from the file is as aligned as one
+ * allocated with BufferAlignment::A64.  When the array has ghost rows, the
+ * header carries an additional "nghost" key.  numpy.load() rejects such a
+ * file, and all other files are plain .npy.
+ *
+ * A file may be read into memory with load_array(), mapped without copying
+ * with map_array(), or read a chunk of rows at a time with ArrayFileReader,
+ * for files bigger than the memory.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace modmesh
+{
+
+/// The payload of an array file starts at a multiple of this number of bytes.
+inline constexpr size_t ARRAY_FILE_ALIGN = 64;
+
+/**
+ * The header of an array file.
+ */
+struct ArrayFileHeader
+{
+
+    /// NumPy array-protocol type string, e.g., "<f8".
+    std::string descr;
+    bool fortran_order = false;
+    small_vector<size_t> shape;
+    size_t nghost = 0;
+    /// Byte offset of the payload in the file.
+    size_t offset = 0;
+
+    size_t nelem() const
+    {
+        size_t ret = 1;
+        for (size_t it = 0; it < shape.size(); ++it)
+        {
+            ret *= shape[it];
+        }
+        return ret;
+    }
+
+    /// Element strides of the payload.
+    small_vector<size_t> stride() const
+    {
+        small_vector<size_t> ret(shape.size());
+        size_t step = 1;
+        for (size_t it = 0; it < shape.size(); ++it)
+        {
+            size_t const axis = fortran_order ? it : shape.size() - 1 - it;
+            ret[axis] = step;
+            step *= shape[axis];
+        }
+        return ret;
+    }
+
+    /// Format the header, including the magic string and the padding, and set offset.
+    std::string format()
+    {
+        std::ostringstream ms;
+        ms << "{'descr': '" << descr << "', 'fortran_order': " << (fortran_order ? "True" : "False") << ", ";
+        if (0 != nghost)
+        {
+            ms << "'nghost': " << nghost << ", ";
+        }
+        ms << "'shape': (";
+        for (size_t it = 0; it < shape.size(); ++it)
+        {
+            ms << (0 == it ? "" : ", ") << shape[it];
+        }
+        ms << (1 == shape.size() ? ",), }" : "), }");
+        std::string dict = ms.str();
+
+        // Version 1.0 has a 2-byte header length and 2.0 a 4-byte one.
+        size_t prefix = MAGIC_SIZE + 2 + 2;
+        size_t length = dict.size() + 1;
+        length += (ARRAY_FILE_ALIGN - (prefix + length) % ARRAY_FILE_ALIGN) % ARRAY_FILE_ALIGN;
+        unsigned char major = 1;
+        if (length > 0xffff)
+        {
+            major = 2;
+            prefix += 2;
+            length = dict.size() + 1;
+            length += (ARRAY_FILE_ALIGN - (prefix + length) % ARRAY_FILE_ALIGN) % ARRAY_FILE_ALIGN;
+        }
+        dict.append(length - dict.size() - 1, ' ');
+        dict.push_back('\n');
+
+        std::string ret(MAGIC, MAGIC_SIZE);
+        ret.push_back(static_cast<char>(major));
+        ret.push_back(0);
+        for (size_t it = 0; it < prefix - MAGIC_SIZE - 2; ++it)
+        {
+            ret.push_back(static_cast<char>((length >> (8 * it)) & 0xff));
+        }
+        ret += dict;
+        offset = ret.size();
+        return ret;
+    }
+
+    /// Read and parse the header from the beginning of the stream.
+    static ArrayFileHeader read(std::istream & is, std::string const & path)
+    {
+        char prefix[MAGIC_SIZE + 2];
+        if (!is.read(prefix, sizeof(prefix)) || 0 != std::memcmp(prefix, MAGIC, MAGIC_SIZE))
+        {
+            throw_format(path, "not an .npy file");
+        }
+        size_t const major = static_cast<unsigned char>(prefix[MAGIC_SIZE]);
+        if (major < 1 || major > 3)
+        {
+            throw_format(path, "unsupported .npy version");
+        }
+        unsigned char lbytes[4] = {0, 0, 0, 0};
+        size_t const nlbyte = 1 == major ? 2 : 4;
+        if (!is.read(reinterpret_cast<char *>(lbytes), static_cast<std::streamsize>(nlbyte)))
+        {
+            throw_format(path, "truncated header");
+        }
+        size_t const length = lbytes[0] | (lbytes[1] << 8) | (size_t(lbytes[2]) << 16) | (size_t(lbytes[3]) << 24);
+        std::string dict(length, '\0');
+        if (!is.read(dict.data(), static_cast<std::streamsize>(length)))
+        {
+            throw_format(path, "truncated header");
+        }
+
+        ArrayFileHeader ret;
+        ret.offset = sizeof(prefix) + nlbyte + length;
+        ret.descr = parse_value(dict, "descr", path);
+        if (ret.descr.size() < 2 || ('\'' != ret.descr.front() && '"' != ret.descr.front()))
+        {
+            throw_format(path, "bad descr");
+        }
+        ret.descr = ret.descr.substr(1, ret.descr.size() - 2);
+        std::string const order = parse_value(dict, "fortran_order", path);
+        if ("True" != order && "False" != order)
+        {
+            throw_format(path, "bad fortran_order");
+        }
+        ret.fortran_order = "True" == order;
+        std::string const shape = parse_value(dict, "shape", path);
+        std::istringstream ss(shape.substr(1, shape.size() - 2));
+        for (std::string token; std::getline(ss, token, ',');)
+        {
+            if (token.find_first_not_of(' ') != std::string::npos)
+            {
+                ret.shape.push_back(std::stoull(token));
+            }
+        }
+        if (dict.find("'nghost'") != std::string::npos)
+        {
+            ret.nghost = std::stoull(parse_value(dict, "nghost", path));
+        }
+        return ret;
+    }
+
+    /// Throw when the type string does not describe T in the native byte order.
+    template <typename T>
+    void check_dtype(std::string const & path) const
+    {
+        std::string const expect = make_descr<T>();
+        bool const native = !descr.empty() && ('=' == descr[0] || '|' == descr[0] || expect[0] == descr[0]);
+        if (!native || descr.substr(1) != expect.substr(1))
+        {
+            std::ostringstream ms;
+            ms << "ArrayFile: " << path << " holds dtype " << descr << " but " << expect << " is requested";
+            throw std::runtime_error(ms.str());
+        }
+    }
+
+    /// NumPy array-protocol type string of T in the native byte order.
+    template <typename T>
+    static std::string make_descr()
+    {
+        static_assert(std::is_arithmetic_v<T>, "ArrayFile supports only arithmetic types");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        char const order = 1 == sizeof(T) ? '|' : '>';
+#else
+        char const order = 1 == sizeof(T) ? '|' : '<';
+#endif
+        char kind = 'u';
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            kind = 'b';
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            kind = 'f';
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            kind = 'i';
+        }
+        return std::string{order, kind} + std::to_string(sizeof(T));
+    }
+
+    static constexpr char const * MAGIC = "\x93NUMPY";
+    static constexpr size_t MAGIC_SIZE = 6;
+
+private:
+
+    /// Return the text of the value of key in the header dictionary.
+    static std::string parse_value(std::string const & dict, char const * key, std::string const & path)
+    {
+        std::string const quoted = std::string("'") + key + "'";
+        size_t pos = dict.find(quoted);
+        if (std::string::npos == pos)
+        {
+            throw_format(path, std::string("no key ") + key);
+        }
+        pos = dict.find(':', pos + quoted.size());
+        pos = std::string::npos == pos ? pos : dict.find_first_not_of(' ', pos + 1);
+        if (std::string::npos == pos)
+        {
+            throw_format(path, std::string("no value of ") + key);
+        }
+        size_t end = std::string::npos;
+        char const head = dict[pos];
+        if ('\'' == head || '"' == head)
+        {
+            end = dict.find(head, pos + 1);
+            end = std::string::npos == end ? end : end + 1;
+        }
+        else if ('(' == head)
+        {
+            end = dict.find(')', pos);
+            end = std::string::npos == end ? end : end + 1;
+        }
+        else
+        {
+            end = dict.find_first_of(",}", pos);
+        }
+        if (std::string::npos == end)
+        {
+            throw_format(path, std::string("bad value of ") + key);
+        }
+        return dict.substr(pos, end - pos);
+    }
+
+    [[noreturn]] static void throw_format(std::string const & path, std::string const & what)
+    {
+        std::ostringstream ms;
+        ms << "ArrayFile: " << path << ": " << what;
+        throw std::runtime_error(ms.str());
+    }
+
+}; /* end struct ArrayFileHeader */
+
+namespace detail
+{
+
+[[noreturn]] inline void array_file_throw_errno(char const * what, std::string const & path)
+{
+    std::ostringstream ms;
+    ms << "ArrayFile: " << what << " " << path << ": " << std::strerror(errno);
+    throw std::runtime_error(ms.str());
+}
+
+template <typename T>
+ArrayFileHeader array_file_open(std::ifstream & is, std::string const & path)
+{
+    is.open(path, std::ios::binary);
+    if (!is)
+    {
+        array_file_throw_errno("cannot open", path);
+    }
+    ArrayFileHeader header = ArrayFileHeader::read(is, path);
+    header.template check_dtype<T>(path);
+    return header;
+}
+
+/// Number of bytes written or read at a time for a non-contiguous array or a stream.
+inline constexpr size_t ARRAY_FILE_CHUNK = 1 << 20;
+
+} /* end namespace detail */
+
+/**
+ * Write arr to path.  A C- or Fortran-contiguous array is written as is;
+ * other arrays are written in C order a few rows at a time.
+ */
+template <typename T>
+void save_array(std::string const & path, SimpleArray<T> const & arr)
+{
+    if (0 == arr.ndim())
+    {
+        throw std::out_of_range("ArrayFile: cannot save an array without dimension");
+    }
+    ArrayFileHeader header;
+    header.descr = ArrayFileHeader::make_descr<T>();
+    header.fortran_order = !arr.is_c_contiguous() && arr.is_f_contiguous();
+    header.shape = arr.shape();
+    header.nghost = arr.nghost();
+
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    if (!os)
+    {
+        detail::array_file_throw_errno("cannot open", path);
+    }
+    os << header.format();
+    size_t const nelem = header.nelem();
+    if (0 != nelem)
+    {
+        if (arr.is_contiguous())
+        {
+            os.write(reinterpret_cast<char const *>(arr.data()), static_cast<std::streamsize>(nelem * sizeof(T)));
+        }
+        else
+        {
+            size_t const rowsize = nelem / arr.shape(0);
+            size_t const nrow = std::max(detail::ARRAY_FILE_CHUNK / std::max(rowsize * sizeof(T), size_t(1)), size_t(1));
+            for (size_t it = 0; it < arr.shape(0); it += nrow)
+            {
+                SimpleArray<T> const chunk = arr.view(0, it, std::min(it + nrow, arr.shape(0))).to_layout(ArrayLayout::C);
+                os.write(reinterpret_cast<char const *>(chunk.data()), static_cast<std::streamsize>(chunk.shape(0) * rowsize * sizeof(T)));
+            }
+        }
+    }
+    if (!os.flush())
+    {
+        detail::array_file_throw_errno("cannot write", path);
+    }
+}
+
+/**
+ * Read the array in path into memory aligned to ARRAY_FILE_ALIGN bytes.
+ */
+template <typename T>
+SimpleArray<T> load_array(std::string const & path)
+{
+    std::ifstream is;
+    ArrayFileHeader const header = detail::array_file_open<T>(is, path);
+    SimpleArray<T> ret(header.shape, header.fortran_order ? ArrayLayout::F : ArrayLayout::C, BufferAlignment::A64);
+    size_t const nbytes = header.nelem() * sizeof(T);
+    if (0 != nbytes && !is.read(reinterpret_cast<char *>(ret.data()), static_cast<std::streamsize>(nbytes)))
+    {
+        std::ostringstream ms;
+        ms << "ArrayFile: " << path << ": payload shorter than " << nbytes << " bytes";
+        throw std::runtime_error(ms.str());
+    }
+    ret.set_nghost(header.nghost);
+    return ret;
+}
+
+/**
+ * Map the array in path without copying.  The pages are read on demand, so
+ * the file may be bigger than the memory.  With BufferMapMode::READWRITE the
+ * changes are written back to the file.  BufferMapMode::CREATE is rejected
+ * because the file must exist; use save_array() to create it.
+ */
+template <typename T>
+SimpleArray<T> map_array(
+    std::string const & path,
+    BufferMapMode mode = BufferMapMode::READ,
+    BufferMapAdvice advice = BufferMapAdvice::NORMAL)
+{
+    if (BufferMapMode::CREATE == mode)
+    {
+        throw std::invalid_argument("ArrayFile: cannot map an array file in CREATE mode");
+    }
+    ArrayFileHeader header;
+    {
+        std::ifstream is;
+        header = detail::array_file_open<T>(is, path);
+    }
+    size_t const nbytes = header.nelem() * sizeof(T);
+    if (0 == nbytes)
+    {
+        return SimpleArray<T>(header.shape);
+    }
+    SimpleArray<T> ret(header.shape, header.stride(), ConcreteBuffer::construct_mmap(path, mode, nbytes, header.offset, advice));
+    ret.set_nghost(header.nghost);
+    return ret;
+}
+
+/**
+ * Read an array file a chunk of rows (along axis 0) at a time.  Only C-ordered
+ * files have contiguous rows; a Fortran-ordered file of more than one
+ * dimension is rejected.
+ */
+template <typename T>
+class ArrayFileReader
+{
+
+public:
+
+    explicit ArrayFileReader(std::string const & path)
+        : m_path(path)
+        , m_header(detail::array_file_open<T>(m_stream, path))
+    {
+        if (0 == m_header.shape.size())
+        {
+            throw std::out_of_range("ArrayFile: cannot read rows of an array without dimension");
+        }
+        if (m_header.fortran_order && m_header.shape.size() > 1)
+        {
+            std::ostringstream ms;
+            ms << "ArrayFile: " << path << ": cannot read rows of a Fortran-ordered array";
+            throw std::runtime_error(ms.str());
+        }
+        m_rowsize = m_header.shape[0] ? m_header.nelem() / m_header.shape[0] : 0;
+    }
+
+    ArrayFileHeader const & header() const { return m_header; }
+    size_t nrow() const { return m_header.shape[0]; }
+    /// Index of the next row to read.
+    size_t position() const { return m_position; }
+    bool eof() const { return m_position >= nrow(); }
+
+    /// Number of rows of about ARRAY_FILE_CHUNK bytes.
+    size_t default_chunk() const
+    {
+        return std::max(detail::ARRAY_FILE_CHUNK / std::max(m_rowsize * sizeof(T), size_t(1)), size_t(1));
+    }
+
+    void seek(size_t row)
+    {
+        m_position = std::min(row, nrow());
+        m_stream.clear();
+        m_stream.seekg(static_cast<std::streamoff>(m_header.offset + m_position * m_rowsize * sizeof(T)));
+    }
+
+    /// Read up to count rows from the position; the returned array has 0 rows at the end.
+    SimpleArray<T> read(size_t count)
+    {
+        small_vector<size_t> shape(m_header.shape);
+        shape[0] = std::min(count, nrow() - m_position);
+        SimpleArray<T> ret(shape, BufferAlignment::A64);
+        size_t const nbytes = shape[0] * m_rowsize * sizeof(T);
+        if (0 != nbytes && !m_stream.read(reinterpret_cast<char *>(ret.data()), static_cast<std::streamsize>(nbytes)))
+        {
+            std::ostringstream ms;
+            ms << "ArrayFile: " << m_path << ": payload ends before row " << m_position + shape[0];
+            throw std::runtime_error(ms.str());
+        }
+        m_position += shape[0];
+        return ret;
+    }
+
+private:
+
+    std::string m_path;
+    std::ifstream m_stream;
+    ArrayFileHeader m_header;
+    size_t m_rowsize = 0;
+    size_t m_position = 0;
+
+}; /* end class ArrayFileReader */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,164 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * The NumPy broadcasting rules for the shapes of the array operands.  Two
+ * shapes are aligned at the last dimension, the missing leading dimensions
+ * count as 1, and a dimension of 1 stretches to the length of the other one.
+ * A stretched dimension is read with the stride 0, so that broadcasting an
+ * operand never copies it.
+ */
+
+#include <modmesh/buffer/small_vector.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <BaseTsd.h>
+typedef SSIZE_T ssize_t;
+#endif
+
+namespace modmesh
+{
+
+namespace detail
+{
+
+template <typename S>
+void print_broadcast_shape(std::ostream & os, S const & shape)
+{
+    os << "(";
+    for (size_t it = 0; it < shape.size(); ++it)
+    {
+        os << shape[it] << (it + 1 < shape.size() ? ", " : "");
+    }
+    os << ")";
+}
+
+/// Length of the dimension counted from the last one, or 1 when missing.
+template <typename S>
+size_t broadcast_extent(S const & shape, size_t rdim)
+{
+    return rdim < shape.size() ? static_cast<size_t>(shape[shape.size() - 1 - rdim]) : 1;
+}
+
+/// Set ret to the broadcast shape of lhs and rhs, or return false if they do not broadcast.
+template <typename L, typename R, size_t N>
+bool try_broadcast_shape(L const & lhs, R const & rhs, small_vector<size_t, N> & ret)
+{
+    size_t const ndim = std::max(lhs.size(), rhs.size());
+    ret.resize(ndim);
+    for (size_t rdim = 0; rdim < ndim; ++rdim)
+    {
+        size_t const lext = broadcast_extent(lhs, rdim);
+        size_t const rext = broadcast_extent(rhs, rdim);
+        if (lext != rext && 1 != lext && 1 != rext)
+        {
+            return false;
+        }
+        ret[ndim - 1 - rdim] = 1 == lext ? rext : lext;
+    }
+    return true;
+}
+
+} /* end namespace detail */
+
+/// Return the shape of broadcasting lhs and rhs together.
+template <typename L, typename R>
+small_vector<size_t> broadcast_shape(L const & lhs, R const & rhs)
+{
+    small_vector<size_t> ret;
+    if (!detail::try_broadcast_shape(lhs, rhs, ret))
+    {
+        std::ostringstream ms;
+        ms << "Broadcast: shapes ";
+        detail::print_broadcast_shape(ms, lhs);
+        ms << " and ";
+        detail::print_broadcast_shape(ms, rhs);
+        ms << " do not broadcast together";
+        throw std::runtime_error(ms.str());
+    }
+    return ret;
+}
+
+/**
+ * Test whether an operand of the shape can be read as the target shape, as
+ * NumPy assigns an array into another.  The extra leading dimensions of the
+ * operand must be 1.
+ */
+template <typename S, size_t N>
+bool is_broadcastable(S const & shape, small_vector<size_t, N> const & target)
+{
+    for (size_t rdim = 0; rdim < shape.size(); ++rdim)
+    {
+        size_t const extent = detail::broadcast_extent(shape, rdim);
+        if (1 != extent && (rdim >= target.size() || extent != target[target.size() - 1 - rdim]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Return the strides to read an operand of the shape and strides as if it
+ * had the target shape.  The stretched and the missing leading dimensions
+ * get the stride 0.
+ */
+template <typename S, typename V, size_t N, size_t M>
+small_vector<V, M> broadcast_stride(S const & shape, small_vector<V, N> const & stride, small_vector<size_t, M> const & target)
+{
+    if (!is_broadcastable(shape, target))
+    {
+        std::ostringstream ms;
+        ms << "Broadcast: cannot broadcast shape ";
+        detail::print_broadcast_shape(ms, shape);
+        ms << " to ";
+        detail::print_broadcast_shape(ms, target);
+        throw std::runtime_error(ms.str());
+    }
+    small_vector<V, M> ret(target.size(), V(0));
+    for (size_t rdim = 0; rdim < std::min(shape.size(), target.size()); ++rdim)
+    {
+        size_t const idim = shape.size() - 1 - rdim;
+        if (static_cast<size_t>(shape[idim]) == target[target.size() - 1 - rdim])
+        {
+            ret[target.size() - 1 - rdim] = stride[idim];
+        }
+    }
+    return ret;
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
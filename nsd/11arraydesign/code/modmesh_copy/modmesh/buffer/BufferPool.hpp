@@ -0,0 +1,470 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Thread-safe size-class memory pool for ConcreteBuffer.  Requests are
+ * rounded up to a power-of-two size class.  Released blocks are kept in a
+ * small per-thread cache and then in global free lists, so that the
+ * repeated allocation of same-sized buffers, e.g., the temporary arrays in
+ * an iterative solver, does not go through the system allocator.
+ *
+ * The pool is disabled by default.  When enabled, ConcreteBuffer::construct
+ * draws from it for the requests it can serve (see pooled()).  Blocks are
+ * aligned to 64 bytes.
+ */
+class BufferPool
+{
+
+public:
+
+    static constexpr size_t MIN_SHIFT = 6; // 64 bytes
+    static constexpr size_t MAX_SHIFT = 30; // 1 GB
+    static constexpr size_t NCLASS = MAX_SHIFT - MIN_SHIFT + 1;
+    static constexpr size_t ALIGNMENT = 64;
+    /// Number of blocks per size class held by the cache of a thread.
+    static constexpr size_t THREAD_CACHE_DEPTH = 4;
+    /// Largest size class held by the caches of the threads (1 MB).  Larger
+    /// blocks go to the global free lists only.
+    static constexpr size_t THREAD_CACHE_MAX_SHIFT = 20;
+    /// Maximum number of bytes held by the cache of a thread.
+    static constexpr size_t THREAD_CACHE_BYTES = size_t(4) << 20;
+
+    /// The singleton.  It is never destroyed so that buffers released
+    /// during static destruction can still return to it.
+    static BufferPool & me()
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        static BufferPool * inst = new BufferPool;
+        return *inst;
+    }
+
+    BufferPool(BufferPool const &) = delete;
+    BufferPool(BufferPool &&) = delete;
+    BufferPool & operator=(BufferPool const &) = delete;
+    BufferPool & operator=(BufferPool &&) = delete;
+
+    ~BufferPool() = default;
+
+    bool enabled() const { return m_enabled; }
+    BufferPool & enable()
+    {
+        m_enabled = true;
+        return *this;
+    }
+    BufferPool & disable()
+    {
+        m_enabled = false;
+        return *this;
+    }
+
+    /// Maximum number of bytes kept in the global free lists and the caches
+    /// of the threads together.  Released blocks exceeding it go back to the
+    /// system.
+    size_t limit() const { return m_limit; }
+    BufferPool & set_limit(size_t nbytes)
+    {
+        m_limit = nbytes;
+        return *this;
+    }
+
+    /// Test whether a request of the size and alignment can be served.
+    static bool pooled(size_t nbytes, size_t alignment)
+    {
+        return 0 != nbytes && nbytes <= (size_t(1) << MAX_SHIFT) && alignment <= ALIGNMENT;
+    }
+
+    /// Index of the size class for a non-zero number of bytes.
+    static size_t size_class(size_t nbytes)
+    {
+        if (nbytes <= class_bytes(0))
+        {
+            return 0;
+        }
+#if defined(__GNUC__)
+        // The bit width of nbytes - 1 is the shift of the class.
+        return static_cast<size_t>(64 - __builtin_clzll(static_cast<unsigned long long>(nbytes - 1))) - MIN_SHIFT;
+#else // __GNUC__
+        size_t icls = 0;
+        while ((size_t(1) << (icls + MIN_SHIFT)) < nbytes)
+        {
+            ++icls;
+        }
+        return icls;
+#endif // __GNUC__
+    }
+
+    static size_t class_bytes(size_t icls) { return size_t(1) << (icls + MIN_SHIFT); }
+
+    /**
+     * Get a block of at least nbytes.  The caller must release it with the
+     * same nbytes.
+     */
+    int8_t * acquire(size_t nbytes)
+    {
+        size_t const icls = size_class(nbytes);
+        ThreadCache * cache = thread_cache();
+        int8_t * ptr = nullptr == cache ? nullptr : cache->pop(icls);
+        if (nullptr != ptr)
+        {
+            return ptr; // The cache counts its own hits.
+        }
+        ptr = pop_global(icls);
+        if (nullptr != ptr)
+        {
+            m_hit_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_miss_count.fetch_add(1, std::memory_order_relaxed);
+            ptr = allocate_block(icls);
+        }
+        return ptr;
+    }
+
+    void release(int8_t * ptr, size_t nbytes)
+    {
+        size_t const icls = size_class(nbytes);
+        ThreadCache * cache = thread_cache();
+        if (nullptr != cache && cache->push(icls, ptr, *this))
+        {
+            return;
+        }
+        if (reserve(class_bytes(icls)))
+        {
+            push_global(icls, ptr);
+        }
+        else
+        {
+            deallocate_block(ptr);
+        }
+    }
+
+    /**
+     * Return the blocks cached by all the threads and in the global free
+     * lists to the system.
+     *
+     * \return Number of bytes returned to the system.
+     */
+    size_t trim()
+    {
+        {
+            std::lock_guard<std::mutex> const lock(m_cache_mutex);
+            for (ThreadCache * cache : m_caches)
+            {
+                cache->flush(*this);
+            }
+        }
+        return release_global();
+    }
+
+    size_t hit_count()
+    {
+        size_t ret = m_hit_count;
+        std::lock_guard<std::mutex> const lock(m_cache_mutex);
+        for (ThreadCache const * cache : m_caches)
+        {
+            ret += cache->nhit.load(std::memory_order_relaxed);
+        }
+        return ret;
+    }
+    size_t miss_count() const { return m_miss_count; }
+    /// Number of bytes in the global free lists and reserved by the caches
+    /// of the threads, which is what limit() bounds.
+    size_t cached_bytes() const { return m_cached_bytes; }
+
+    void reset_count()
+    {
+        m_hit_count = 0;
+        m_miss_count = 0;
+        std::lock_guard<std::mutex> const lock(m_cache_mutex);
+        for (ThreadCache * cache : m_caches)
+        {
+            cache->nhit.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+
+    /**
+     * Cache of a thread, holding the blocks up to THREAD_CACHE_MAX_SHIFT and
+     * THREAD_CACHE_BYTES in total.  It reserves its bytes against limit()
+     * as its high-water mark grows and keeps the reservation until flushed,
+     * so that the cycles below the mark do not touch the shared counter.
+     * Its lock is taken by the owning thread only, except when trim()
+     * flushes it, so it is not contended.  It is flushed to the global free
+     * lists when the thread exits.
+     */
+    struct ThreadCache
+    {
+
+        /// Spin lock, cheaper than std::mutex when not contended.
+        class CacheLock
+        {
+        public:
+            explicit CacheLock(std::atomic_flag & flag)
+                : m_flag(flag)
+            {
+                while (m_flag.test_and_set(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+            CacheLock(CacheLock const &) = delete;
+            CacheLock(CacheLock &&) = delete;
+            CacheLock & operator=(CacheLock const &) = delete;
+            CacheLock & operator=(CacheLock &&) = delete;
+            ~CacheLock() { m_flag.clear(std::memory_order_release); }
+
+        private:
+            std::atomic_flag & m_flag;
+        }; /* end class CacheLock */
+
+        static constexpr size_t NCACHED = THREAD_CACHE_MAX_SHIFT - MIN_SHIFT + 1;
+
+        ThreadCache() { BufferPool::me().register_cache(this); }
+        ThreadCache(ThreadCache const &) = delete;
+        ThreadCache(ThreadCache &&) = delete;
+        ThreadCache & operator=(ThreadCache const &) = delete;
+        ThreadCache & operator=(ThreadCache &&) = delete;
+
+        ~ThreadCache()
+        {
+            BufferPool & pool = BufferPool::me();
+            pool.unregister_cache(this);
+            pool.m_hit_count.fetch_add(nhit, std::memory_order_relaxed);
+            flush(pool);
+            thread_cache_gone() = true;
+        }
+
+        int8_t * pop(size_t icls)
+        {
+            if (icls >= NCACHED)
+            {
+                return nullptr;
+            }
+            CacheLock const lock(busy);
+            size_t & cnt = count[icls];
+            if (0 == cnt)
+            {
+                return nullptr;
+            }
+            nbytes -= class_bytes(icls);
+            // Only the owner writes the count, so no atomic increment is needed.
+            nhit.store(nhit.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return blocks[icls][--cnt];
+        }
+
+        bool push(size_t icls, int8_t * ptr, BufferPool & pool)
+        {
+            if (icls >= NCACHED)
+            {
+                return false;
+            }
+            CacheLock const lock(busy);
+            size_t & cnt = count[icls];
+            size_t const need = nbytes + class_bytes(icls);
+            if (cnt >= THREAD_CACHE_DEPTH || need > THREAD_CACHE_BYTES)
+            {
+                return false;
+            }
+            if (need > quota)
+            {
+                if (!pool.reserve(need - quota))
+                {
+                    return false;
+                }
+                quota = need;
+            }
+            nbytes = need;
+            blocks[icls][cnt++] = ptr;
+            return true;
+        }
+
+        /// Move the blocks to the global free lists, which take over their
+        /// reserved bytes, and return the rest of the reservation.
+        void flush(BufferPool & pool)
+        {
+            CacheLock const lock(busy);
+            for (size_t icls = 0; icls < NCACHED; ++icls)
+            {
+                while (0 != count[icls])
+                {
+                    pool.push_global(icls, blocks[icls][--count[icls]]);
+                }
+            }
+            pool.m_cached_bytes -= quota - nbytes;
+            quota = 0;
+            nbytes = 0;
+        }
+
+        std::atomic_flag busy = ATOMIC_FLAG_INIT;
+        std::array<std::array<int8_t *, THREAD_CACHE_DEPTH>, NCACHED> blocks{};
+        std::array<size_t, NCACHED> count{};
+        size_t nbytes = 0; // Bytes of the blocks held.
+        size_t quota = 0; // Bytes reserved against the limit.
+        std::atomic<size_t> nhit{0}; // Blocks served, read by hit_count().
+
+    }; /* end struct ThreadCache */
+
+    BufferPool() = default;
+
+    /// Trivially destructible, so it outlives the cache in the thread.
+    static bool & thread_cache_gone()
+    {
+        thread_local bool gone = false;
+        return gone;
+    }
+
+    /// Return nullptr after the cache of the thread is destroyed.
+    static ThreadCache * thread_cache()
+    {
+        if (thread_cache_gone())
+        {
+            return nullptr;
+        }
+        thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    void register_cache(ThreadCache * cache)
+    {
+        std::lock_guard<std::mutex> const lock(m_cache_mutex);
+        m_caches.push_back(cache);
+    }
+
+    void unregister_cache(ThreadCache * cache)
+    {
+        std::lock_guard<std::mutex> const lock(m_cache_mutex);
+        m_caches.erase(std::find(m_caches.begin(), m_caches.end(), cache));
+    }
+
+    static int8_t * allocate_block(size_t icls)
+    {
+        return static_cast<int8_t *>(::operator new(class_bytes(icls), std::align_val_t(ALIGNMENT)));
+    }
+
+    static void deallocate_block(int8_t * ptr)
+    {
+        ::operator delete(ptr, std::align_val_t(ALIGNMENT));
+    }
+
+    int8_t * pop_global(size_t icls)
+    {
+        int8_t * ptr = nullptr;
+        {
+            std::lock_guard<std::mutex> const lock(m_mutex[icls]);
+            std::vector<int8_t *> & blocks = m_free[icls];
+            if (!blocks.empty())
+            {
+                ptr = blocks.back();
+                blocks.pop_back();
+            }
+        }
+        if (nullptr != ptr)
+        {
+            m_cached_bytes -= class_bytes(icls);
+        }
+        return ptr;
+    }
+
+    size_t release_global()
+    {
+        size_t ret = 0;
+        for (size_t icls = 0; icls < NCLASS; ++icls)
+        {
+            std::vector<int8_t *> blocks;
+            {
+                std::lock_guard<std::mutex> const lock(m_mutex[icls]);
+                blocks.swap(m_free[icls]);
+            }
+            for (int8_t * ptr : blocks)
+            {
+                deallocate_block(ptr);
+            }
+            ret += blocks.size() * class_bytes(icls);
+        }
+        m_cached_bytes -= ret;
+        return ret;
+    }
+
+    /**
+     * Count the bytes to be cached against the limit.  The test and the
+     * increment are one atomic step, so that concurrent releases do not
+     * overshoot it.
+     */
+    bool reserve(size_t nbytes)
+    {
+        size_t const limit = m_limit;
+        size_t cur = m_cached_bytes.load();
+        do
+        {
+            if (cur + nbytes > limit)
+            {
+                return false;
+            }
+        } while (!m_cached_bytes.compare_exchange_weak(cur, cur + nbytes));
+        return true;
+    }
+
+    /// Push a block whose bytes are reserved.
+    void push_global(size_t icls, int8_t * ptr)
+    {
+        std::lock_guard<std::mutex> const lock(m_mutex[icls]);
+        m_free[icls].push_back(ptr);
+    }
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<size_t> m_limit{size_t(1) << 32};
+    std::atomic<size_t> m_hit_count{0};
+    std::atomic<size_t> m_miss_count{0};
+    std::atomic<size_t> m_cached_bytes{0};
+    std::array<std::mutex, NCLASS> m_mutex;
+    std::array<std::vector<int8_t *>, NCLASS> m_free;
+    std::mutex m_cache_mutex;
+    std::vector<ThreadCache *> m_caches;
+
+}; /* end class BufferPool */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,564 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Compressed storage of a mostly-constant array in fixed-size chunks.
+ *
+ * The elements, in C order, are cut into chunks of the same number of
+ * elements.  A chunk is compressed by shuffling the bytes, so that byte k of
+ * every element is grouped together, and then run-length encoding the
+ * result.  The bytes of the same significance in a smooth or constant field
+ * repeat, so the runs are long.  A chunk that does not shrink is stored as is.
+ *
+ * Element access decompresses the chunk into a small LRU cache.  Writes go to
+ * the cached chunk and are compressed back when the chunk is evicted or
+ * flushed.  The cache makes element access not thread-safe.  The conversions
+ * from and to SimpleArray work on the chunks in parallel.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Options of ChunkedArray.
+ */
+struct ChunkedOptions
+{
+    /// Number of elements in a chunk.
+    size_t chunk_size = 1 << 14;
+    /// Number of decompressed chunks kept for element access.
+    size_t cache_size = 8;
+    /// Number of threads for the conversions; 0 uses std::thread::hardware_concurrency().
+    size_t nthread = 0;
+}; /* end struct ChunkedOptions */
+
+namespace detail
+{
+
+/*
+ * A compressed chunk starts with a codec byte.  The RLE stream is a sequence
+ * of tokens: a kind byte, a variable-length count, and either count literal
+ * bytes or the single byte repeated count times.
+ */
+enum : uint8_t
+{
+    CHUNK_RAW = 0,
+    CHUNK_SHUFFLE_RLE = 1
+};
+enum : uint8_t
+{
+    RLE_LITERAL = 0,
+    RLE_RUN = 1
+};
+/// A shorter run costs more to encode than to keep in the literals.
+inline constexpr size_t RLE_MIN_RUN = 4;
+
+inline void rle_put_count(std::vector<uint8_t> & out, size_t count)
+{
+    while (count >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(count | 0x80));
+        count >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(count));
+}
+
+inline size_t rle_get_count(uint8_t const *& in, uint8_t const * end)
+{
+    size_t count = 0;
+    for (size_t shift = 0; in < end; shift += 7)
+    {
+        uint8_t const byte = *in++;
+        count |= size_t(byte & 0x7f) << shift;
+        if (0 == (byte & 0x80))
+        {
+            return count;
+        }
+    }
+    throw std::runtime_error("ChunkedArray: truncated chunk");
+}
+
+inline void rle_encode(uint8_t const * in, size_t nbytes, std::vector<uint8_t> & out)
+{
+    size_t literal = 0;
+    size_t it = 0;
+    auto flush_literal = [&]()
+    {
+        if (0 != literal)
+        {
+            out.push_back(RLE_LITERAL);
+            rle_put_count(out, literal);
+            out.insert(out.end(), in + it - literal, in + it);
+            literal = 0;
+        }
+    };
+    while (it < nbytes)
+    {
+        size_t run = 1;
+        while (it + run < nbytes && in[it + run] == in[it])
+        {
+            ++run;
+        }
+        if (run >= RLE_MIN_RUN)
+        {
+            flush_literal();
+            out.push_back(RLE_RUN);
+            rle_put_count(out, run);
+            out.push_back(in[it]);
+            it += run;
+        }
+        else
+        {
+            literal += run;
+            it += run;
+        }
+    }
+    flush_literal();
+}
+
+inline void rle_decode(uint8_t const * in, uint8_t const * end, uint8_t * out, size_t nbytes)
+{
+    uint8_t * const out_end = out + nbytes;
+    while (in < end)
+    {
+        uint8_t const kind = *in++;
+        size_t const count = rle_get_count(in, end);
+        if (count > static_cast<size_t>(out_end - out) || (RLE_RUN == kind ? 1 : count) > static_cast<size_t>(end - in))
+        {
+            throw std::runtime_error("ChunkedArray: corrupted chunk");
+        }
+        if (RLE_RUN == kind)
+        {
+            std::memset(out, *in++, count);
+        }
+        else
+        {
+            std::memcpy(out, in, count);
+            in += count;
+        }
+        out += count;
+    }
+    if (out != out_end)
+    {
+        throw std::runtime_error("ChunkedArray: truncated chunk");
+    }
+}
+
+/// Compress nelem elements of itemsize bytes.  scratch holds the shuffled bytes.
+inline void chunk_encode(void const * data, size_t nelem, size_t itemsize, std::vector<uint8_t> & scratch, std::vector<uint8_t> & out)
+{
+    auto const * bytes = static_cast<uint8_t const *>(data);
+    size_t const nbytes = nelem * itemsize;
+    scratch.resize(nbytes);
+    for (size_t ie = 0; ie < nelem; ++ie)
+    {
+        for (size_t ib = 0; ib < itemsize; ++ib)
+        {
+            scratch[ib * nelem + ie] = bytes[ie * itemsize + ib];
+        }
+    }
+    out.clear();
+    out.push_back(CHUNK_SHUFFLE_RLE);
+    rle_encode(scratch.data(), nbytes, out);
+    if (out.size() >= nbytes + 1)
+    {
+        out.assign(1, CHUNK_RAW);
+        out.insert(out.end(), bytes, bytes + nbytes);
+    }
+    out.shrink_to_fit();
+}
+
+inline void chunk_decode(std::vector<uint8_t> const & in, void * data, size_t nelem, size_t itemsize, std::vector<uint8_t> & scratch)
+{
+    size_t const nbytes = nelem * itemsize;
+    if (in.empty())
+    {
+        throw std::runtime_error("ChunkedArray: empty chunk");
+    }
+    if (CHUNK_RAW == in[0])
+    {
+        if (in.size() != nbytes + 1)
+        {
+            throw std::runtime_error("ChunkedArray: corrupted chunk");
+        }
+        std::memcpy(data, in.data() + 1, nbytes);
+        return;
+    }
+    scratch.resize(nbytes);
+    rle_decode(in.data() + 1, in.data() + in.size(), scratch.data(), nbytes);
+    auto * bytes = static_cast<uint8_t *>(data);
+    for (size_t ib = 0; ib < itemsize; ++ib)
+    {
+        for (size_t ie = 0; ie < nelem; ++ie)
+        {
+            bytes[ie * itemsize + ib] = scratch[ib * nelem + ie];
+        }
+    }
+}
+
+/// Run work(begin, end) over nchunk chunks, each thread taking a contiguous range.
+template <typename W>
+void chunked_parallel(size_t nchunk, size_t nthread, W && work)
+{
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nthread = std::max(std::min(nthread, nchunk), size_t(1));
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (size_t it = 1; it < nthread; ++it)
+    {
+        threads.emplace_back(work, nchunk * it / nthread, nchunk * (it + 1) / nthread);
+    }
+    work(0, nchunk / nthread);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+}
+
+} /* end namespace detail */
+
+template <typename T>
+class ChunkedArray
+{
+
+    static_assert(std::is_trivially_copyable_v<T>, "ChunkedArray needs a trivially copyable element type");
+
+public:
+
+    using value_type = T;
+    using shape_type = small_vector<size_t>;
+
+    static constexpr size_t ITEMSIZE = sizeof(value_type);
+
+    /// Fill every element with value.
+    explicit ChunkedArray(shape_type const & shape, value_type const & value = value_type(), ChunkedOptions const & options = {})
+        : ChunkedArray(allocate_tag{}, shape, options)
+    {
+        // All the full chunks are the same; compress one and copy it.
+        std::vector<value_type> const raw(m_chunk_size, value);
+        std::vector<uint8_t> scratch;
+        for (size_t ic = 0; ic < nchunk(); ++ic)
+        {
+            if (0 == ic || chunk_nelem(ic) != m_chunk_size)
+            {
+                detail::chunk_encode(raw.data(), chunk_nelem(ic), ITEMSIZE, scratch, m_chunks[ic]);
+            }
+            else
+            {
+                m_chunks[ic] = m_chunks[0];
+            }
+        }
+    }
+
+    /// Compress the elements of arr in C order, a thread per range of chunks.
+    explicit ChunkedArray(SimpleArray<value_type> const & arr, ChunkedOptions const & options = {})
+        : ChunkedArray(allocate_tag{}, arr.shape(), options)
+    {
+        m_nghost = arr.nghost();
+        // Read a C-contiguous array in place and copy only the others, so
+        // that a large grid is not duplicated first.
+        SimpleArray<value_type> copied;
+        if (!arr.is_c_contiguous())
+        {
+            copied = arr.to_layout(ArrayLayout::C);
+        }
+        value_type const * data = arr.is_c_contiguous() ? arr.data() : std::as_const(copied).data();
+        detail::chunked_parallel(
+            nchunk(),
+            options.nthread,
+            [&](size_t begin, size_t end)
+            {
+                std::vector<uint8_t> scratch;
+                for (size_t ic = begin; ic < end; ++ic)
+                {
+                    detail::chunk_encode(data + ic * m_chunk_size, chunk_nelem(ic), ITEMSIZE, scratch, m_chunks[ic]);
+                }
+            });
+    }
+
+    ChunkedArray(ChunkedArray const &) = default;
+    ChunkedArray(ChunkedArray &&) = default;
+    ChunkedArray & operator=(ChunkedArray const &) = default;
+    ChunkedArray & operator=(ChunkedArray &&) = default;
+    ~ChunkedArray() = default;
+
+    /// Decompress into a C-contiguous SimpleArray, a thread per range of chunks.
+    SimpleArray<value_type> to_simple() const
+    {
+        SimpleArray<value_type> ret(m_shape);
+        value_type * data = ret.data();
+        detail::chunked_parallel(
+            nchunk(),
+            m_nthread,
+            [&](size_t begin, size_t end)
+            {
+                std::vector<uint8_t> scratch;
+                for (size_t ic = begin; ic < end; ++ic)
+                {
+                    // A written chunk in the cache is newer than the compressed one.
+                    CacheSlot const * slot = find_slot(ic);
+                    if (slot && slot->dirty)
+                    {
+                        std::copy_n(slot->data.data(), chunk_nelem(ic), data + ic * m_chunk_size);
+                    }
+                    else
+                    {
+                        detail::chunk_decode(m_chunks[ic], data + ic * m_chunk_size, chunk_nelem(ic), ITEMSIZE, scratch);
+                    }
+                }
+            });
+        ret.set_nghost(m_nghost);
+        return ret;
+    }
+
+    shape_type const & shape() const { return m_shape; }
+    size_t shape(size_t it) const { return m_shape[it]; }
+    size_t ndim() const { return m_shape.size(); }
+    size_t size() const { return m_size; }
+    size_t chunk_size() const { return m_chunk_size; }
+    size_t nchunk() const { return m_chunks.size(); }
+    /// The nghost of the SimpleArray converted from, restored by to_simple().
+    size_t nghost() const { return m_nghost; }
+
+    /// Number of bytes of the compressed chunks, not including the cache.
+    size_t nbytes() const
+    {
+        size_t ret = 0;
+        for (std::vector<uint8_t> const & chunk : m_chunks)
+        {
+            ret += chunk.size();
+        }
+        return ret;
+    }
+
+    /// Number of bytes of the uncompressed elements.
+    size_t raw_nbytes() const { return m_size * ITEMSIZE; }
+
+    size_t hit_count() const { return m_hit_count; }
+    size_t miss_count() const { return m_miss_count; }
+
+    /// Read by the flat index in C order, counting the ghost rows from 0.
+    value_type get(size_t it) const
+    {
+        check_range(it);
+        return slot_for(it / m_chunk_size).data[it % m_chunk_size];
+    }
+
+    void set(size_t it, value_type const & value)
+    {
+        check_range(it);
+        CacheSlot & slot = slot_for(it / m_chunk_size);
+        slot.data[it % m_chunk_size] = value;
+        slot.dirty = true;
+    }
+
+    /**
+     * Read by the indices like SimpleArray::operator(): the first one counts
+     * from the first body row, so that a ghost row is negative.  Each index
+     * is checked against its dimension.
+     */
+    template <typename... Args>
+    value_type operator()(Args... args) const
+    {
+        return get(flat_index(args...));
+    }
+
+    /// Compress the written chunks in the cache back into the storage.
+    void flush() const
+    {
+        for (CacheSlot & slot : m_cache)
+        {
+            write_back(slot);
+        }
+    }
+
+private:
+
+    struct CacheSlot
+    {
+        size_t ichunk = std::numeric_limits<size_t>::max();
+        std::vector<value_type> data;
+        bool dirty = false;
+        size_t stamp = 0;
+    }; /* end struct CacheSlot */
+
+    struct allocate_tag
+    {
+    };
+
+    /// Size the chunk storage without filling it.
+    ChunkedArray(allocate_tag, shape_type const & shape, ChunkedOptions const & options)
+        : m_shape(shape)
+        , m_chunk_size(std::max(options.chunk_size, size_t(1)))
+        , m_nthread(options.nthread)
+        , m_cache(std::max(options.cache_size, size_t(1)))
+    {
+        m_size = 1;
+        for (size_t it = 0; it < m_shape.size(); ++it)
+        {
+            m_size *= m_shape[it];
+        }
+        if (m_shape.empty())
+        {
+            m_size = 0;
+        }
+        m_chunks.resize((m_size + m_chunk_size - 1) / m_chunk_size);
+    }
+
+    size_t chunk_nelem(size_t ic) const { return std::min(m_chunk_size, m_size - ic * m_chunk_size); }
+
+    void check_range(size_t it) const
+    {
+        if (it >= m_size)
+        {
+            std::ostringstream ms;
+            ms << "ChunkedArray: index " << it << " is out of bounds with size " << m_size;
+            throw std::out_of_range(ms.str());
+        }
+    }
+
+    template <typename... Args>
+    size_t flat_index(Args... args) const
+    {
+        ssize_t index[] = {static_cast<ssize_t>(args)...};
+        if (sizeof...(args) != ndim())
+        {
+            std::ostringstream ms;
+            ms << "ChunkedArray: " << sizeof...(args) << " indices for " << ndim() << "-dimensional array";
+            throw std::out_of_range(ms.str());
+        }
+        index[0] += static_cast<ssize_t>(m_nghost);
+        size_t ret = 0;
+        for (size_t it = 0; it < sizeof...(args); ++it)
+        {
+            if (index[it] < 0 || static_cast<size_t>(index[it]) >= m_shape[it])
+            {
+                std::ostringstream ms;
+                ms << "ChunkedArray: index " << index[it] - (0 == it ? static_cast<ssize_t>(m_nghost) : 0)
+                   << " of dim " << it << " is out of bounds with shape " << m_shape[it];
+                if (0 == it)
+                {
+                    ms << " (nghost: " << m_nghost << ")";
+                }
+                throw std::out_of_range(ms.str());
+            }
+            ret = ret * m_shape[it] + static_cast<size_t>(index[it]);
+        }
+        return ret;
+    }
+
+    CacheSlot const * find_slot(size_t ic) const
+    {
+        for (CacheSlot const & slot : m_cache)
+        {
+            if (slot.ichunk == ic)
+            {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    void write_back(CacheSlot & slot) const
+    {
+        if (slot.dirty)
+        {
+            detail::chunk_encode(slot.data.data(), chunk_nelem(slot.ichunk), ITEMSIZE, m_scratch, m_chunks[slot.ichunk]);
+            slot.dirty = false;
+        }
+    }
+
+    /// Return the cache slot holding chunk ic, decompressing it into the least recently used slot on a miss.
+    CacheSlot & slot_for(size_t ic) const
+    {
+        CacheSlot & last = m_cache[m_last];
+        if (last.ichunk == ic)
+        {
+            ++m_hit_count;
+            return last;
+        }
+        size_t victim = 0;
+        for (size_t it = 0; it < m_cache.size(); ++it)
+        {
+            if (m_cache[it].ichunk == ic)
+            {
+                ++m_hit_count;
+                m_cache[it].stamp = ++m_clock;
+                m_last = it;
+                return m_cache[it];
+            }
+            victim = m_cache[it].stamp < m_cache[victim].stamp ? it : victim;
+        }
+        ++m_miss_count;
+        CacheSlot & slot = m_cache[victim];
+        write_back(slot);
+        slot.ichunk = ic;
+        slot.data.resize(m_chunk_size);
+        detail::chunk_decode(m_chunks[ic], slot.data.data(), chunk_nelem(ic), ITEMSIZE, m_scratch);
+        slot.stamp = ++m_clock;
+        m_last = victim;
+        return slot;
+    }
+
+    shape_type m_shape;
+    size_t m_size = 0;
+    size_t m_chunk_size = 0;
+    size_t m_nthread = 0;
+    size_t m_nghost = 0;
+    // The cache writes back into the chunks on eviction, including in the const accessors.
+    mutable std::vector<std::vector<uint8_t>> m_chunks;
+    mutable std::vector<CacheSlot> m_cache;
+    mutable std::vector<uint8_t> m_scratch;
+    mutable size_t m_last = 0;
+    mutable size_t m_clock = 0;
+    mutable size_t m_hit_count = 0;
+    mutable size_t m_miss_count = 0;
+
+}; /* end class ChunkedArray */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
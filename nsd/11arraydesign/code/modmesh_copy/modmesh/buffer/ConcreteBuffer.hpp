@@ -29,18 +29,231 @@
  */
 
 #include <modmesh/buffer/small_vector.hpp>
+#include <modmesh/buffer/BufferPool.hpp>
 
 #include <stdexcept>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <new>
 #include <sstream>
+#include <cstdlib>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif // __linux__
 
 namespace modmesh
 {
 
+/**
+ * Alignment policy of the memory allocated by ConcreteBuffer.  DEFAULT uses
+ * the plain new[] and gets whatever alignment the C++ runtime offers
+ * (usually 16 bytes).  The others request the alignment in bytes.
+ */
+enum class BufferAlignment : size_t
+{
+    DEFAULT = 0,
+    A16 = 16,
+    A32 = 32,
+    A64 = 64,
+    PAGE = 4096,
+    /// Backed by huge pages when the system allows; see BufferHugePage.
+    HUGEPAGE = 2 * 1024 * 1024
+}; /* end enum class BufferAlignment */
+
+/**
+ * Process-wide setting of the huge-page allocation of ConcreteBuffer.  A
+ * buffer asks for huge pages with BufferAlignment::HUGEPAGE, or gets them when
+ * it is at least threshold() bytes.  With large strides every access of a
+ * grid may land on a different 4 KB page and miss the TLB, while a 2 MB page
+ * covers 512 of them.
+ *
+ * The memory is a 2 MB-aligned anonymous mapping advised with MADV_HUGEPAGE,
+ * for the transparent huge pages of Linux.  When hugetlb() is set, an
+ * explicit MAP_HUGETLB mapping from the pages reserved in
+ * /proc/sys/vm/nr_hugepages is tried first.  The system may decline either,
+ * and then the buffer silently uses normal pages.
+ */
+class BufferHugePage
+{
+
+public:
+
+    static constexpr size_t PAGE_BYTES = static_cast<size_t>(BufferAlignment::HUGEPAGE);
+
+    /// The singleton.
+    static BufferHugePage & me()
+    {
+        static BufferHugePage inst;
+        return inst;
+    }
+
+    BufferHugePage(BufferHugePage const &) = delete;
+    BufferHugePage(BufferHugePage &&) = delete;
+    BufferHugePage & operator=(BufferHugePage const &) = delete;
+    BufferHugePage & operator=(BufferHugePage &&) = delete;
+
+    ~BufferHugePage() = default;
+
+    /// Number of bytes from which a buffer uses huge pages whatever the
+    /// alignment asked.  0 (the default) turns it off.
+    size_t threshold() const { return m_threshold; }
+    BufferHugePage & set_threshold(size_t nbytes)
+    {
+        m_threshold = nbytes;
+        return *this;
+    }
+
+    /// Whether to try the explicit hugetlbfs pages before the transparent ones.
+    bool hugetlb() const { return m_hugetlb; }
+    BufferHugePage & set_hugetlb(bool value)
+    {
+        m_hugetlb = value;
+        return *this;
+    }
+
+    /// The alignment to allocate nbytes asked with alignment.
+    BufferAlignment resolve(size_t nbytes, BufferAlignment alignment) const
+    {
+        size_t const threshold = m_threshold;
+        return (0 != threshold && nbytes >= threshold) ? BufferAlignment::HUGEPAGE : alignment;
+    }
+
+private:
+
+    BufferHugePage() = default;
+
+    std::atomic<size_t> m_threshold{0};
+    std::atomic<bool> m_hugetlb{false};
+
+}; /* end class BufferHugePage */
+
+/**
+ * How a file is mapped into a ConcreteBuffer.  The modes follow those of
+ * numpy.memmap.
+ */
+enum class BufferMapMode
+{
+    READ, ///< "r": read-only; writing to the buffer is a segmentation fault.
+    READWRITE, ///< "r+": read and write an existing file.
+    CREATE, ///< "w+": create or overwrite the file and read and write it.
+    COPY ///< "c": copy-on-write; changes are not written back to the file.
+}; /* end enum class BufferMapMode */
+
+/**
+ * Access pattern hint passed to madvise() for a file-mapped ConcreteBuffer.
+ */
+enum class BufferMapAdvice
+{
+    NORMAL,
+    SEQUENTIAL,
+    RANDOM,
+    WILLNEED
+}; /* end enum class BufferMapAdvice */
+
+/**
+ * Placement of the pages of ConcreteBuffer::construct_numa() on the NUMA
+ * nodes.
+ */
+enum class BufferNumaPolicy
+{
+    FIRST_TOUCH, ///< A page goes to the node of the thread writing it first.
+    INTERLEAVE ///< The pages go round-robin over the online nodes (mbind(MPOL_INTERLEAVE)).
+}; /* end enum class BufferNumaPolicy */
+
+/**
+ * Options of ConcreteBuffer::construct_numa().
+ */
+struct BufferNumaOptions
+{
+    BufferNumaPolicy policy = BufferNumaPolicy::FIRST_TOUCH;
+    /// Number of threads; 0 uses std::thread::hardware_concurrency().
+    size_t nthread = 0;
+}; /* end struct BufferNumaOptions */
+
 namespace detail
 {
 
+/**
+ * Run work(ithread, nthread) on nthread threads.  Thread ithread is meant to
+ * take the range [n * ithread / nthread, n * (ithread + 1) / nthread) of n
+ * items, the static partition of the threaded kernels, so that the pages it
+ * touches first are the ones it processes later.
+ */
+template <typename W>
+void numa_parallel(size_t nthread, W && work)
+{
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (size_t it = 1; it < nthread; ++it)
+    {
+        threads.emplace_back(work, it, nthread);
+    }
+    work(0, nthread);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Ask the kernel to interleave the pages of the range over the online NUMA
+ * nodes.  It is only a hint: return false without an error when there is a
+ * single node, or the system does not support it.
+ */
+inline bool numa_interleave(void * addr, size_t length)
+{
+#if defined(__linux__)
+    // The node list is like "0-1,3".  Nodes beyond the bits of a long are left out.
+    unsigned long mask = 0;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string range;
+    while (std::getline(online, range, ','))
+    {
+        unsigned long first = 0;
+        unsigned long last = 0;
+        char * end = nullptr;
+        first = std::strtoul(range.c_str(), &end, 10);
+        last = '-' == *end ? std::strtoul(end + 1, nullptr, 10) : first;
+        for (unsigned long node = first; node <= last && node < sizeof(mask) * 8; ++node)
+        {
+            mask |= 1UL << node;
+        }
+    }
+    if (0 == (mask & (mask - 1)))
+    {
+        return false;
+    }
+    constexpr int mpol_interleave = 3; // MPOL_INTERLEAVE of <numaif.h>, without linking libnuma.
+    // The kernel reads maxnode - 1 bits.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    return 0 == ::syscall(SYS_mbind, addr, length, mpol_interleave, &mask, sizeof(mask) * 8 + 1, 0);
+#else // __linux__
+    (void)addr;
+    (void)length;
+    return false;
+#endif // __linux__
+}
+
 // Take the remover and deleter classes outside ConcreteBuffer to work around
 // https://bugzilla.redhat.com/show_bug.cgi?id=1569374
 
@@ -76,6 +289,500 @@ struct ConcreteBufferNoRemove : public ConcreteBufferRemover
 
 }; /* end struct ConcreteBufferNoRemove */
 
+/**
+ * Remover for the memory obtained from the aligned allocator, which must not
+ * be released by delete[].
+ */
+struct ConcreteBufferAlignedRemover : public ConcreteBufferRemover
+{
+
+    static int8_t * allocate(size_t nbytes, size_t alignment)
+    {
+        // The aligned allocators want the size to be a multiple of the
+        // alignment.
+        size_t const nalloc = (nbytes + alignment - 1) / alignment * alignment;
+        void * ptr = nullptr;
+#if defined(_MSC_VER)
+        ptr = _aligned_malloc(nalloc, alignment);
+#else // _MSC_VER
+        if (0 != posix_memalign(&ptr, alignment, nalloc))
+        {
+            ptr = nullptr;
+        }
+#endif // _MSC_VER
+        if (nullptr == ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<int8_t *>(ptr);
+    }
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,readability-non-const-parameter)
+    void operator()(int8_t * p) const override
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else // _MSC_VER
+        // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,cppcoreguidelines-owning-memory)
+        std::free(p);
+#endif // _MSC_VER
+    }
+
+}; /* end struct ConcreteBufferAlignedRemover */
+
+/**
+ * Remover of a buffer viewing the memory of another ConcreteBuffer.  It keeps
+ * the viewed buffer alive and does not release anything by itself.
+ */
+template <typename B>
+struct ConcreteBufferViewRemover : public ConcreteBufferRemover
+{
+
+    explicit ConcreteBufferViewRemover(std::shared_ptr<B> base_in)
+        : base(std::move(base_in))
+    {
+    }
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,readability-non-const-parameter)
+    void operator()(int8_t *) const override {}
+
+    std::shared_ptr<B> base;
+
+}; /* end struct ConcreteBufferViewRemover */
+
+/**
+ * Remover for the memory mapped from a file.  The mapping starts at a page
+ * boundary that may precede the data pointer, so the remover keeps the base
+ * address and the length for munmap().
+ */
+struct ConcreteBufferMmapRemover : public ConcreteBufferRemover
+{
+
+    ConcreteBufferMmapRemover(void * base_in, size_t length_in)
+        : base(base_in)
+        , length(length_in)
+    {
+    }
+
+    /**
+     * Map nbytes of the file at path starting from offset.  When nbytes is
+     * 0, map through the end of the file.  Return the mapped data pointer
+     * and set the number of bytes mapped and the remover.
+     */
+    static int8_t * map(
+        std::string const & path,
+        BufferMapMode mode,
+        size_t & nbytes,
+        size_t offset,
+        BufferMapAdvice advice,
+        std::unique_ptr<ConcreteBufferRemover> & remover)
+    {
+#if defined(_WIN32)
+        throw std::runtime_error("ConcreteBuffer: mmap is not supported on Windows");
+#else // _WIN32
+        int flags = O_RDONLY;
+        int prot = PROT_READ;
+        int share = MAP_SHARED;
+        switch (mode)
+        {
+        case BufferMapMode::READ:
+            break;
+        case BufferMapMode::READWRITE:
+            flags = O_RDWR;
+            prot = PROT_READ | PROT_WRITE;
+            break;
+        case BufferMapMode::CREATE:
+            flags = O_RDWR | O_CREAT | O_TRUNC;
+            prot = PROT_READ | PROT_WRITE;
+            break;
+        case BufferMapMode::COPY:
+            prot = PROT_READ | PROT_WRITE;
+            share = MAP_PRIVATE;
+            break;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+        int const fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0)
+        {
+            throw_errno("cannot open", path);
+        }
+        struct stat st
+        {
+        };
+        if (0 != ::fstat(fd, &st))
+        {
+            ::close(fd);
+            throw_errno("cannot stat", path);
+        }
+        size_t fsize = static_cast<size_t>(st.st_size);
+        if (0 == nbytes)
+        {
+            if (offset > fsize)
+            {
+                ::close(fd);
+                throw_range(path, offset, 0, fsize);
+            }
+            nbytes = fsize - offset;
+        }
+        if (offset + nbytes > fsize)
+        {
+            if (BufferMapMode::READWRITE == mode || BufferMapMode::CREATE == mode)
+            {
+                if (0 != ::ftruncate(fd, static_cast<off_t>(offset + nbytes)))
+                {
+                    ::close(fd);
+                    throw_errno("cannot resize", path);
+                }
+                fsize = offset + nbytes;
+            }
+            else
+            {
+                ::close(fd);
+                throw_range(path, offset, nbytes, fsize);
+            }
+        }
+        if (0 == nbytes)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        // The offset of mmap() must be a multiple of the page size.
+        auto const pagesize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t const base_offset = offset / pagesize * pagesize;
+        size_t const length = nbytes + (offset - base_offset);
+        void * base = ::mmap(nullptr, length, prot, share, fd, static_cast<off_t>(base_offset));
+        // The mapping holds its own reference to the file.
+        ::close(fd);
+        if (MAP_FAILED == base)
+        {
+            throw_errno("cannot mmap", path);
+        }
+
+        int madv = MADV_NORMAL;
+        switch (advice)
+        {
+        case BufferMapAdvice::NORMAL:
+            break;
+        case BufferMapAdvice::SEQUENTIAL:
+            madv = MADV_SEQUENTIAL;
+            break;
+        case BufferMapAdvice::RANDOM:
+            madv = MADV_RANDOM;
+            break;
+        case BufferMapAdvice::WILLNEED:
+            madv = MADV_WILLNEED;
+            break;
+        }
+        if (MADV_NORMAL != madv)
+        {
+            // The advice is only a hint; ignore failure.
+            ::madvise(base, length, madv);
+        }
+
+        remover = std::make_unique<ConcreteBufferMmapRemover>(base, length);
+        return static_cast<int8_t *>(base) + (offset - base_offset);
+#endif // _WIN32
+    }
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,readability-non-const-parameter)
+    void operator()(int8_t *) const override
+    {
+#if !defined(_WIN32)
+        if (nullptr != base)
+        {
+            ::munmap(base, length);
+        }
+#endif // _WIN32
+    }
+
+    void * base = nullptr;
+    size_t length = 0;
+
+private:
+
+    [[noreturn]] static void throw_errno(char const * what, std::string const & path)
+    {
+        std::ostringstream ms;
+        ms << "ConcreteBuffer: " << what << " " << path << ": " << std::strerror(errno);
+        throw std::runtime_error(ms.str());
+    }
+
+    [[noreturn]] static void throw_range(std::string const & path, size_t offset, size_t nbytes, size_t fsize)
+    {
+        std::ostringstream ms;
+        ms << "ConcreteBuffer: cannot map " << nbytes << " bytes at offset " << offset
+           << " from " << path << " of " << fsize << " bytes";
+        throw std::out_of_range(ms.str());
+    }
+
+}; /* end struct ConcreteBufferMmapRemover */
+
+/**
+ * Remover for a POSIX shared-memory segment of shm_open().  The segment
+ * starts with a header holding the number of data bytes and the number of
+ * ConcreteBuffer attached to it in all processes.  The remover detaches, and
+ * the last one to detach unlinks the name.  A process that dies without
+ * detaching leaves the segment behind; remove it with
+ * ConcreteBuffer::unlink_shm().
+ *
+ * The count may also hold references in transit to another process (see
+ * retain()), which the receiver adopts when attaching.  A child forked from
+ * the attaching process inherits the mapping but not a reference, so the
+ * remover of the child only unmaps.
+ */
+struct ConcreteBufferShmRemover : public ConcreteBufferRemover
+{
+
+    struct Header
+    {
+        std::atomic<uint64_t> magic;
+        uint64_t nbytes;
+        std::atomic<uint64_t> nattach;
+    }; /* end struct Header */
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory reference count needs lock-free atomics");
+
+    static constexpr uint64_t MAGIC = 0x4d4d534853484d31; // "MMSHSHM1"
+    /// The data follow the header at this offset to keep the 64-byte alignment.
+    static constexpr size_t HEADER_BYTES = 64;
+
+    static_assert(sizeof(Header) <= HEADER_BYTES, "shared-memory header too large");
+
+    ConcreteBufferShmRemover(std::string name_in, void * base_in, size_t length_in)
+        : name(std::move(name_in))
+        , base(base_in)
+        , length(length_in)
+#if !defined(_WIN32)
+        , pid(::getpid())
+#endif // _WIN32
+    {
+    }
+
+    /**
+     * Create the segment of name for nbytes of data, attached once.  An empty
+     * name makes up one unique to the process.  Return the data pointer and
+     * set the remover.
+     */
+    static int8_t * create(std::string name, size_t nbytes, std::unique_ptr<ConcreteBufferRemover> & remover)
+    {
+#if defined(_WIN32)
+        (void)name;
+        (void)nbytes;
+        (void)remover;
+        throw std::runtime_error("ConcreteBuffer: shared memory is not supported on Windows");
+#else // _WIN32
+        if (name.empty())
+        {
+            static std::atomic<size_t> serial{0};
+            std::ostringstream ms;
+            ms << "/modmesh-" << ::getpid() << "-" << serial.fetch_add(1);
+            name = ms.str();
+        }
+        name = normalize(name);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg,hicpp-signed-bitwise)
+        int const fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            throw_errno("cannot create shared memory", name);
+        }
+        size_t const length = HEADER_BYTES + nbytes;
+        if (0 != ::ftruncate(fd, static_cast<off_t>(length)))
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw_errno("cannot resize shared memory", name);
+        }
+        void * base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == base)
+        {
+            ::shm_unlink(name.c_str());
+            throw_errno("cannot mmap shared memory", name);
+        }
+        // The segment is not attachable before the magic is stored.
+        auto * header = new (base) Header{{0}, nbytes, {1}};
+        header->magic.store(MAGIC, std::memory_order_release);
+        remover = std::make_unique<ConcreteBufferShmRemover>(name, base, length);
+        return static_cast<int8_t *>(base) + HEADER_BYTES;
+#endif // _WIN32
+    }
+
+    /**
+     * Attach to the segment of name.  Return the data pointer and set the
+     * number of bytes and the remover.  With adopt, take over a reference
+     * left by retain() instead of adding one.
+     */
+    static int8_t * attach(std::string name, size_t & nbytes, std::unique_ptr<ConcreteBufferRemover> & remover, bool adopt)
+    {
+#if defined(_WIN32)
+        (void)name;
+        (void)nbytes;
+        (void)remover;
+        (void)adopt;
+        throw std::runtime_error("ConcreteBuffer: shared memory is not supported on Windows");
+#else // _WIN32
+        name = normalize(name);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+        int const fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0)
+        {
+            throw_errno("cannot open shared memory", name);
+        }
+        struct stat st
+        {
+        };
+        if (0 != ::fstat(fd, &st))
+        {
+            ::close(fd);
+            throw_errno("cannot stat shared memory", name);
+        }
+        auto const length = static_cast<size_t>(st.st_size);
+        if (length < HEADER_BYTES)
+        {
+            ::close(fd);
+            throw_invalid(name);
+        }
+        void * base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == base)
+        {
+            throw_errno("cannot mmap shared memory", name);
+        }
+        auto * header = static_cast<Header *>(base);
+        if (MAGIC != header->magic.load(std::memory_order_acquire) || HEADER_BYTES + header->nbytes != length)
+        {
+            ::munmap(base, length);
+            throw_invalid(name);
+        }
+        // Do not revive a segment whose last buffer is detaching.  An adopted
+        // reference keeps the count above zero.
+        uint64_t count = header->nattach.load(std::memory_order_relaxed);
+        do
+        {
+            if (0 == count)
+            {
+                ::munmap(base, length);
+                std::ostringstream ms;
+                ms << "ConcreteBuffer: shared memory " << name << " is being released";
+                throw std::runtime_error(ms.str());
+            }
+        } while (!adopt && !header->nattach.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel));
+        nbytes = header->nbytes;
+        remover = std::make_unique<ConcreteBufferShmRemover>(name, base, length);
+        return static_cast<int8_t *>(base) + HEADER_BYTES;
+#endif // _WIN32
+    }
+
+    /// Names of shm_open() start with a slash.
+    static std::string normalize(std::string const & name)
+    {
+        return ('/' == name[0]) ? name : "/" + name;
+    }
+
+    /// Add a reference for a receiver to adopt by attach().
+    void retain() const
+    {
+        static_cast<Header *>(base)->nattach.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,readability-non-const-parameter)
+    void operator()(int8_t *) const override
+    {
+#if !defined(_WIN32)
+        if (nullptr != base)
+        {
+            // A forked child did not add the reference of the parent.
+            auto * header = static_cast<Header *>(base);
+            if (::getpid() == pid && 1 == header->nattach.fetch_sub(1, std::memory_order_acq_rel))
+            {
+                ::shm_unlink(name.c_str());
+            }
+            ::munmap(base, length);
+        }
+#endif // _WIN32
+    }
+
+    std::string name;
+    void * base = nullptr;
+    size_t length = 0;
+#if !defined(_WIN32)
+    /// The process holding the reference.
+    pid_t pid = 0;
+#endif // _WIN32
+
+private:
+
+    [[noreturn]] static void throw_errno(char const * what, std::string const & name)
+    {
+        std::ostringstream ms;
+        ms << "ConcreteBuffer: " << what << " " << name << ": " << std::strerror(errno);
+        throw std::runtime_error(ms.str());
+    }
+
+    [[noreturn]] static void throw_invalid(std::string const & name)
+    {
+        std::ostringstream ms;
+        ms << "ConcreteBuffer: " << name << " is not a shared-memory buffer";
+        throw std::runtime_error(ms.str());
+    }
+
+}; /* end struct ConcreteBufferShmRemover */
+
+/**
+ * Allocate nbytes on huge pages as described in BufferHugePage and set the
+ * remover to release them.
+ */
+inline int8_t * allocate_hugepage(size_t nbytes, std::unique_ptr<ConcreteBufferRemover> & remover)
+{
+    constexpr size_t hsize = BufferHugePage::PAGE_BYTES;
+    size_t const length = (nbytes + hsize - 1) / hsize * hsize;
+#if defined(_WIN32)
+    // Large pages need a privilege on Windows; settle for the alignment.
+    remover = std::make_unique<ConcreteBufferAlignedRemover>();
+    return ConcreteBufferAlignedRemover::allocate(length, hsize);
+#else // _WIN32
+#if defined(MAP_HUGETLB)
+    if (BufferHugePage::me().hugetlb())
+    {
+        // NOLINTNEXTLINE(hicpp-signed-bitwise)
+        void * base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (MAP_FAILED != base)
+        {
+            remover = std::make_unique<ConcreteBufferMmapRemover>(base, length);
+            return static_cast<int8_t *>(base);
+        }
+    }
+#endif // MAP_HUGETLB
+    // Map one more huge page to align the start, and unmap the excess.
+    // NOLINTNEXTLINE(hicpp-signed-bitwise)
+    void * base = ::mmap(nullptr, length + hsize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == base)
+    {
+        throw std::bad_alloc();
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const addr = reinterpret_cast<uintptr_t>(base);
+    size_t const head = (hsize - addr % hsize) % hsize;
+    int8_t * data = static_cast<int8_t *>(base) + head;
+    if (0 != head)
+    {
+        ::munmap(base, head);
+    }
+    if (hsize != head)
+    {
+        ::munmap(data + length, hsize - head);
+    }
+#if defined(MADV_HUGEPAGE)
+    // The advice is only a hint; ignore failure.
+    ::madvise(data, length, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+    remover = std::make_unique<ConcreteBufferMmapRemover>(data, length);
+    return data;
+#endif // _WIN32
+}
+
 struct ConcreteBufferDataDeleter
 {
 
@@ -93,10 +800,20 @@ struct ConcreteBufferDataDeleter
     {
     }
 
+    /// Return the memory to BufferPool, without allocating a remover.
+    explicit ConcreteBufferDataDeleter(size_t pooled_in)
+        : pooled(pooled_in)
+    {
+    }
+
     // NOLINTNEXTLINE(modernize-avoid-c-arrays,cppcoreguidelines-avoid-c-arrays,readability-non-const-parameter)
     void operator()(int8_t * p) const
     {
-        if (!remover)
+        if (0 != pooled)
+        {
+            BufferPool::me().release(p, pooled);
+        }
+        else if (!remover)
         {
             // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
             delete[] p;
@@ -108,6 +825,8 @@ struct ConcreteBufferDataDeleter
     }
 
     std::unique_ptr<remover_type> remover{nullptr};
+    /// Number of bytes acquired from BufferPool, or 0 when not pooled.
+    size_t pooled = 0;
 
 }; /* end struct ConcreteBufferDataDeleter */
 
@@ -131,10 +850,11 @@ private:
 public:
 
     using remover_type = detail::ConcreteBufferRemover;
+    using alignment_type = BufferAlignment;
 
-    static std::shared_ptr<ConcreteBuffer> construct(size_t nbytes)
+    static std::shared_ptr<ConcreteBuffer> construct(size_t nbytes, alignment_type alignment = alignment_type::DEFAULT)
     {
-        return std::make_shared<ConcreteBuffer>(nbytes, ctor_passkey());
+        return std::make_shared<ConcreteBuffer>(nbytes, alignment, ctor_passkey());
     }
 
     /*
@@ -155,9 +875,158 @@ public:
 
     static std::shared_ptr<ConcreteBuffer> construct() { return construct(0); }
 
+    /**
+     * Map a file into a buffer without reading it into the heap.
+     *
+     * \param[in] path
+     *      Path of the file to map.
+     * \param[in] mode
+     *      See BufferMapMode.  READWRITE and CREATE extend the file when it is
+     *      shorter than offset + nbytes.
+     * \param[in] nbytes
+     *      Number of bytes to map.  0 maps through the end of the file.
+     * \param[in] offset
+     *      Byte offset in the file where the buffer starts.  It does not need
+     *      to be page-aligned.
+     * \param[in] advice
+     *      Access pattern hint for madvise().
+     */
+    static std::shared_ptr<ConcreteBuffer> construct_mmap(
+        std::string const & path,
+        BufferMapMode mode = BufferMapMode::READ,
+        size_t nbytes = 0,
+        size_t offset = 0,
+        BufferMapAdvice advice = BufferMapAdvice::NORMAL)
+    {
+        std::unique_ptr<remover_type> remover;
+        int8_t * data = detail::ConcreteBufferMmapRemover::map(path, mode, nbytes, offset, advice, remover);
+        if (nullptr == data)
+        {
+            return construct(0);
+        }
+        std::shared_ptr<ConcreteBuffer> ret = construct(nbytes, data, std::move(remover));
+        // The pages of a read-only mapping fault on write.
+        ret->m_readonly = BufferMapMode::READ == mode;
+        return ret;
+    }
+
+    /**
+     * Create a zero-filled buffer in POSIX shared memory under name, which
+     * another process passes to attach_shm() to use the same physical
+     * memory.  An empty name makes up a unique one; see shm_name().  The name
+     * is unlinked when the last buffer attached to it in any process is
+     * destroyed.
+     */
+    static std::shared_ptr<ConcreteBuffer> construct_shm(size_t nbytes, std::string const & name = "")
+    {
+        std::unique_ptr<remover_type> remover;
+        int8_t * data = detail::ConcreteBufferShmRemover::create(name, nbytes, remover);
+        return construct(nbytes, data, std::move(remover));
+    }
+
+    /**
+     * Attach to the shared memory created by construct_shm() under name.
+     * With adopt, take over the reference added by retain_shm() instead of
+     * adding one.
+     */
+    static std::shared_ptr<ConcreteBuffer> attach_shm(std::string const & name, bool adopt = false)
+    {
+        size_t nbytes = 0;
+        std::unique_ptr<remover_type> remover;
+        int8_t * data = detail::ConcreteBufferShmRemover::attach(name, nbytes, remover, adopt);
+        return construct(nbytes, data, std::move(remover));
+    }
+
+    /// Remove the name of a shared memory left behind by a dead process.
+    static void unlink_shm(std::string const & name)
+    {
+#if !defined(_WIN32)
+        ::shm_unlink(detail::ConcreteBufferShmRemover::normalize(name).c_str());
+#endif // _WIN32
+    }
+
+    /**
+     * Allocate a zero-filled buffer whose pages are placed for the threads
+     * that will use it.  The memory is mapped fresh from the system, so no
+     * page exists until written, and the pages are then written by
+     * options.nthread threads, each over a contiguous range of the buffer.
+     * With the first-touch policy of the operating system a page lands on
+     * the NUMA node of the thread that processes it in a kernel partitioned
+     * the same way, rather than all on the node of the allocating thread.
+     * BufferPool is not used.
+     */
+    static std::shared_ptr<ConcreteBuffer> construct_numa(size_t nbytes, BufferNumaOptions const & options = {})
+    {
+        if (0 == nbytes)
+        {
+            return construct(0);
+        }
+#if defined(_WIN32)
+        std::shared_ptr<ConcreteBuffer> ret = construct(nbytes, alignment_type::PAGE);
+        int8_t * data = ret->data();
+        detail::numa_parallel(
+            options.nthread,
+            [&](size_t ithread, size_t nthread)
+            {
+                size_t const begin = nbytes * ithread / nthread;
+                size_t const end = nbytes * (ithread + 1) / nthread;
+                std::memset(data + begin, 0, end - begin);
+            });
+#else // _WIN32
+        // NOLINTNEXTLINE(hicpp-signed-bitwise)
+        void * base = ::mmap(nullptr, nbytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == base)
+        {
+            throw std::bad_alloc();
+        }
+        if (BufferNumaPolicy::INTERLEAVE == options.policy)
+        {
+            detail::numa_interleave(base, nbytes);
+        }
+        std::shared_ptr<ConcreteBuffer> ret = construct(nbytes, base, std::make_unique<detail::ConcreteBufferMmapRemover>(base, nbytes));
+        ret->m_alignment = alignment_type::PAGE;
+        // An anonymous mapping reads zero; writing a byte of each page places it.
+        volatile int8_t * data = ret->data();
+        auto const pagesize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        detail::numa_parallel(
+            options.nthread,
+            [&](size_t ithread, size_t nthread)
+            {
+                size_t const begin = (nbytes * ithread / nthread + pagesize - 1) / pagesize * pagesize;
+                size_t const end = nbytes * (ithread + 1) / nthread;
+                for (size_t it = begin; it < end; it += pagesize)
+                {
+                    data[it] = 0;
+                }
+            });
+#endif // _WIN32
+        return ret;
+    }
+
+    /**
+     * Create a buffer of nbytes starting at the byte offset of this buffer
+     * without copying.  The returned buffer keeps this one alive.
+     */
+    std::shared_ptr<ConcreteBuffer> view(size_t offset, size_t nbytes)
+    {
+        if (offset + nbytes > size())
+        {
+            std::ostringstream ms;
+            ms << "ConcreteBuffer: view of " << nbytes << " bytes at offset " << offset
+               << " is out of bounds with size " << size();
+            throw std::out_of_range(ms.str());
+        }
+        std::shared_ptr<ConcreteBuffer> ret = construct(
+            nbytes,
+            data() + offset,
+            std::make_unique<detail::ConcreteBufferViewRemover<ConcreteBuffer>>(shared_from_this()));
+        ret->m_readonly = m_readonly;
+        return ret;
+    }
+
     std::shared_ptr<ConcreteBuffer> clone() const
     {
-        std::shared_ptr<ConcreteBuffer> ret = construct(nbytes());
+        std::shared_ptr<ConcreteBuffer> ret = construct(nbytes(), alignment());
         std::copy_n(data(), size(), (*ret).data());
         return ret;
     }
@@ -165,10 +1034,13 @@ public:
     /**
      * \param[in] nbytes
      *      Size of the memory buffer in bytes.
+     * \param[in] alignment
+     *      Alignment policy of the allocated memory.
      */
-    ConcreteBuffer(size_t nbytes, const ctor_passkey &)
+    ConcreteBuffer(size_t nbytes, alignment_type alignment, const ctor_passkey &)
         : m_nbytes(nbytes)
-        , m_data(allocate(nbytes))
+        , m_alignment(BufferHugePage::me().resolve(nbytes, alignment))
+        , m_data(allocate(nbytes, m_alignment))
     {
     }
 
@@ -201,7 +1073,8 @@ public:
     // NOLINTNEXTLINE(bugprone-copy-constructor-init)
     ConcreteBuffer(ConcreteBuffer const & other)
         : m_nbytes(other.m_nbytes)
-        , m_data(allocate(other.m_nbytes))
+        , m_alignment(other.m_alignment)
+        , m_data(allocate(other.m_nbytes, other.m_alignment))
     {
         if (size() != other.size())
         {
@@ -220,6 +1093,7 @@ public:
             {
                 throw std::out_of_range("Buffer size mismatch");
             }
+            validate_writable();
             std::copy_n(other.data(), size(), data());
         }
         return *this;
@@ -227,9 +1101,34 @@ public:
 
     explicit operator bool() const noexcept { return bool(m_data); }
 
+    /**
+     * Test whether the memory must not be written, like a file mapped with
+     * BufferMapMode::READ.  The flag is not enforced on the data pointer;
+     * the Python wrappers check it, and a clone() is writable.
+     */
+    bool readonly() const noexcept { return m_readonly; }
+
+    void validate_writable() const
+    {
+        if (m_readonly)
+        {
+            throw std::runtime_error("ConcreteBuffer: buffer is read-only");
+        }
+    }
+
     size_t nbytes() const noexcept { return m_nbytes; }
     size_t size() const noexcept { return nbytes(); }
 
+    /// The alignment policy requested when allocating the buffer.  Buffers
+    /// wrapping external memory report DEFAULT.
+    alignment_type alignment() const noexcept { return m_alignment; }
+    /// Test whether the data pointer is aligned to the given bytes.
+    bool is_aligned(size_t bytes) const noexcept
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return 0 == bytes || 0 == reinterpret_cast<uintptr_t>(m_data.get()) % bytes;
+    }
+
     using iterator = int8_t *;
     using const_iterator = int8_t const *;
 
@@ -267,6 +1166,32 @@ public:
     // clang-format on
 
     bool has_remover() const noexcept { return bool(m_data.get_deleter().remover); }
+    /// Test whether the buffer is a view() of another one.
+    bool is_view() const noexcept
+    {
+        return nullptr != dynamic_cast<detail::ConcreteBufferViewRemover<ConcreteBuffer> const *>(m_data.get_deleter().remover.get());
+    }
+    /// Name of the shared memory from construct_shm() or attach_shm(), or empty.
+    std::string shm_name() const
+    {
+        auto const * remover = dynamic_cast<detail::ConcreteBufferShmRemover const *>(m_data.get_deleter().remover.get());
+        return nullptr == remover ? std::string() : remover->name;
+    }
+    /**
+     * Add a reference to the shared memory for another process, which takes
+     * it over by attach_shm(name, true).  The segment then survives this
+     * buffer until the receiver attaches.  Each call needs exactly one such
+     * attach, or the segment is left behind.
+     */
+    void retain_shm() const
+    {
+        auto const * remover = dynamic_cast<detail::ConcreteBufferShmRemover const *>(m_data.get_deleter().remover.get());
+        if (nullptr == remover)
+        {
+            throw std::runtime_error("ConcreteBuffer: not a shared-memory buffer");
+        }
+        remover->retain();
+    }
     remover_type const & get_remover() const { return *m_data.get_deleter().remover; }
     remover_type & get_remover() { return *m_data.get_deleter().remover; }
 
@@ -283,17 +1208,40 @@ public:
         }
     }
 
-    static unique_ptr_type allocate(size_t nbytes)
+    static unique_ptr_type allocate(size_t nbytes, alignment_type alignment = alignment_type::DEFAULT)
     {
+        using aligned_remover_type = detail::ConcreteBufferAlignedRemover;
         unique_ptr_type ret(nullptr, data_deleter_type());
         if (0 != nbytes)
         {
-            ret = unique_ptr_type(new int8_t[nbytes], data_deleter_type());
+            BufferPool & pool = BufferPool::me();
+            if (alignment_type::HUGEPAGE == alignment)
+            {
+                std::unique_ptr<remover_type> remover;
+                int8_t * data = detail::allocate_hugepage(nbytes, remover);
+                ret = unique_ptr_type(data, data_deleter_type(std::move(remover)));
+            }
+            else if (pool.enabled() && BufferPool::pooled(nbytes, static_cast<size_t>(alignment)))
+            {
+                ret = unique_ptr_type(pool.acquire(nbytes), data_deleter_type(nbytes));
+            }
+            else if (alignment_type::DEFAULT == alignment)
+            {
+                ret = unique_ptr_type(new int8_t[nbytes], data_deleter_type());
+            }
+            else
+            {
+                ret = unique_ptr_type(
+                    aligned_remover_type::allocate(nbytes, static_cast<size_t>(alignment)),
+                    data_deleter_type(std::make_unique<aligned_remover_type>()));
+            }
         }
         return ret;
     }
 
     size_t m_nbytes;
+    alignment_type m_alignment = alignment_type::DEFAULT;
+    bool m_readonly = false;
     unique_ptr_type m_data;
 
 }; /* end class ConcreteBuffer */
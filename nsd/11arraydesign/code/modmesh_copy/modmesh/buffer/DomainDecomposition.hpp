@@ -0,0 +1,439 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Split a 1- or 2-D SimpleArray grid into blocks with ghost layers, so that
+ * each thread sweeps its own cache-local block and only reads the neighbors
+ * through the halo exchanged between the sweeps.
+ *
+ * A block is a SimpleArray extended by nghost elements on both sides of every
+ * axis.  The ghost rows in front are the nghost of the array, so that row 0 is
+ * the first body row and row -1 is a ghost.  The trailing ghost rows follow
+ * the body.  Along axis 1 the body starts at column nghost.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+namespace detail
+{
+
+/**
+ * Block the threads of a team until all of them arrive.  The team takes turns
+ * by the generation so that the barrier can be reused right away.
+ */
+class HaloBarrier
+{
+
+public:
+
+    explicit HaloBarrier(size_t count)
+        : m_count(count)
+    {
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        size_t const generation = m_generation;
+        if (++m_waiting == m_count)
+        {
+            m_waiting = 0;
+            ++m_generation;
+            m_cond.notify_all();
+        }
+        else
+        {
+            m_cond.wait(lock, [&]() { return generation != m_generation; });
+        }
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    size_t m_count = 0;
+    size_t m_waiting = 0;
+    size_t m_generation = 0;
+
+}; /* end class HaloBarrier */
+
+} /* end namespace detail */
+
+class DomainDecomposition
+{
+
+public:
+
+    using shape_type = small_vector<size_t>;
+
+    /**
+     * Cut a grid of shape into npart[it] blocks along axis it.  Each block is
+     * at least nghost long on every axis, so that its halo comes from the
+     * adjacent blocks only.
+     */
+    DomainDecomposition(shape_type const & shape, shape_type const & npart, size_t nghost = 1)
+        : m_shape(shape)
+        , m_npart(npart)
+        , m_nghost(nghost)
+    {
+        if (m_shape.size() < 1 || m_shape.size() > 2)
+        {
+            std::ostringstream ms;
+            ms << "DomainDecomposition: " << m_shape.size() << "-dimensional grid is not supported";
+            throw std::out_of_range(ms.str());
+        }
+        if (m_npart.size() != m_shape.size())
+        {
+            std::ostringstream ms;
+            ms << "DomainDecomposition: " << m_npart.size() << " partition counts for "
+               << m_shape.size() << "-dimensional grid";
+            throw std::out_of_range(ms.str());
+        }
+        for (size_t it = 0; it < m_shape.size(); ++it)
+        {
+            if (0 == m_npart[it] || m_shape[it] / m_npart[it] < std::max(m_nghost, size_t(1)))
+            {
+                std::ostringstream ms;
+                ms << "DomainDecomposition: cannot cut " << m_shape[it] << " into " << m_npart[it]
+                   << " parts of at least " << std::max(m_nghost, size_t(1));
+                throw std::out_of_range(ms.str());
+            }
+        }
+    }
+
+    size_t ndim() const { return m_shape.size(); }
+    shape_type const & shape() const { return m_shape; }
+    shape_type const & npart() const { return m_npart; }
+    size_t nghost() const { return m_nghost; }
+    size_t nblock() const { return npart(0) * npart(1); }
+
+    /// Number of parts along axis; 1 for the missing axis of a 1-D grid.
+    size_t npart(size_t axis) const { return axis < ndim() ? m_npart[axis] : 1; }
+    /// Index of the block along axis.
+    size_t part(size_t ib, size_t axis) const { return 0 == axis ? ib / npart(1) : ib % npart(1); }
+
+    /// Global index of the first body element of block ib along axis.
+    size_t offset(size_t ib, size_t axis) const
+    {
+        return axis < ndim() ? m_shape[axis] * part(ib, axis) / m_npart[axis] : 0;
+    }
+
+    /// Number of body elements of block ib along axis.
+    size_t extent(size_t ib, size_t axis) const
+    {
+        if (axis >= ndim())
+        {
+            return 1;
+        }
+        size_t const ip = part(ib, axis);
+        return m_shape[axis] * (ip + 1) / m_npart[axis] - m_shape[axis] * ip / m_npart[axis];
+    }
+
+    /// Allocate the array of block ib with the ghost layers.
+    template <typename T>
+    SimpleArray<T> make_block(size_t ib) const
+    {
+        shape_type shape(ndim());
+        for (size_t it = 0; it < ndim(); ++it)
+        {
+            shape[it] = extent(ib, it) + 2 * m_nghost;
+        }
+        SimpleArray<T> ret(shape);
+        ret.set_nghost(m_nghost);
+        return ret;
+    }
+
+    /**
+     * Allocate all the blocks and fill them, including the ghosts inside the
+     * grid, from the global array.
+     */
+    template <typename T>
+    std::vector<SimpleArray<T>> scatter(SimpleArray<T> const & global) const
+    {
+        check_global(global);
+        std::vector<SimpleArray<T>> blocks;
+        blocks.reserve(nblock());
+        for (size_t ib = 0; ib < nblock(); ++ib)
+        {
+            blocks.push_back(make_block<T>(ib));
+            Box const box = intersect(extended_box(ib), Box{{0, 0}, {m_shape[0], 1 == ndim() ? 1 : m_shape[1]}});
+            copy_box(box, global_frame<T const>(global), block_frame<T>(blocks[ib], ib));
+        }
+        return blocks;
+    }
+
+    /// Copy the bodies of the blocks into the global array.
+    template <typename T>
+    void gather(std::vector<SimpleArray<T>> const & blocks, SimpleArray<T> & global) const
+    {
+        check_global(global);
+        check_blocks(blocks);
+        for (size_t ib = 0; ib < nblock(); ++ib)
+        {
+            copy_box(body_box(ib), block_frame<T const>(blocks[ib], ib), global_frame<T>(global));
+        }
+    }
+
+    /**
+     * Fill the ghosts of block ib from the bodies of its (up to 8) neighbors.
+     * The ghosts outside the grid are left alone.  Blocks may exchange in
+     * parallel, because a block only writes its own ghosts and only reads
+     * the bodies of the others.
+     */
+    template <typename T>
+    void exchange(std::vector<SimpleArray<T>> & blocks, size_t ib) const
+    {
+        Box const ext = extended_box(ib);
+        size_t const p0 = part(ib, 0);
+        size_t const p1 = part(ib, 1);
+        for (size_t q0 = p0 > 0 ? p0 - 1 : 0; q0 <= std::min(p0 + 1, npart(0) - 1); ++q0)
+        {
+            for (size_t q1 = p1 > 0 ? p1 - 1 : 0; q1 <= std::min(p1 + 1, npart(1) - 1); ++q1)
+            {
+                size_t const jb = q0 * npart(1) + q1;
+                if (jb == ib)
+                {
+                    continue;
+                }
+                Box const box = intersect(ext, body_box(jb));
+                copy_box(box, block_frame<T const>(std::as_const(blocks[jb]), jb), block_frame<T>(blocks[ib], ib));
+            }
+        }
+    }
+
+    /// Fill the ghosts of all the blocks.
+    template <typename T>
+    void exchange(std::vector<SimpleArray<T>> & blocks) const
+    {
+        check_blocks(blocks);
+        for (size_t ib = 0; ib < nblock(); ++ib)
+        {
+            exchange(blocks, ib);
+        }
+    }
+
+    /**
+     * Iterate sweeps with a thread per block.  In a step, sweep(ib) updates
+     * blocks[ib] and returns the residual of the block.  The threads then
+     * wait for each other, exchange the halos of their own blocks, and stop
+     * together when the maximum residual is below tolerance or after
+     * max_step steps.  Return the number of steps and the last residual.
+     *
+     * The sweep may swap blocks[ib] with a scratch array of the same shape,
+     * for the Jacobi update of solve1().
+     */
+    template <typename T, typename F>
+    std::pair<size_t, double> iterate(std::vector<SimpleArray<T>> & blocks, F && sweep, double tolerance, size_t max_step) const
+    {
+        check_blocks(blocks);
+        std::vector<double> residuals(nblock(), 0.0);
+        std::vector<std::pair<size_t, double>> results(nblock());
+        detail::HaloBarrier barrier(nblock());
+
+        auto work = [&](size_t ib)
+        {
+            size_t step = 0;
+            double residual = 0.0;
+            while (step < max_step)
+            {
+                ++step;
+                residuals[ib] = sweep(ib);
+                barrier.wait();
+                exchange(blocks, ib);
+                residual = *std::max_element(residuals.begin(), residuals.end());
+                // Nobody writes a residual of the next step before all have read this one.
+                barrier.wait();
+                if (residual < tolerance)
+                {
+                    break;
+                }
+            }
+            results[ib] = std::make_pair(step, residual);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nblock() - 1);
+        for (size_t ib = 1; ib < nblock(); ++ib)
+        {
+            threads.emplace_back(work, ib);
+        }
+        work(0);
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+        return results[0];
+    }
+
+private:
+
+    /// Half-open index range [begin, end) along the two axes.
+    struct Box
+    {
+        size_t begin[2];
+        size_t end[2];
+    }; /* end struct Box */
+
+    static Box intersect(Box const & a, Box const & b)
+    {
+        Box ret;
+        for (size_t it = 0; it < 2; ++it)
+        {
+            ret.begin[it] = std::max(a.begin[it], b.begin[it]);
+            ret.end[it] = std::max(std::min(a.end[it], b.end[it]), ret.begin[it]);
+        }
+        return ret;
+    }
+
+    /// Width of the ghost layer along axis; 0 for the missing axis of a 1-D grid.
+    size_t ghost(size_t axis) const { return axis < ndim() ? m_nghost : 0; }
+
+    Box body_box(size_t ib) const
+    {
+        return Box{{offset(ib, 0), offset(ib, 1)}, {offset(ib, 0) + extent(ib, 0), offset(ib, 1) + extent(ib, 1)}};
+    }
+
+    /// The body and the ghosts of block ib, clipped to the non-negative global indices.
+    Box extended_box(size_t ib) const
+    {
+        Box ret = body_box(ib);
+        for (size_t it = 0; it < 2; ++it)
+        {
+            ret.begin[it] = ret.begin[it] >= ghost(it) ? ret.begin[it] - ghost(it) : 0;
+            ret.end[it] += ghost(it);
+        }
+        return ret;
+    }
+
+    /**
+     * Locate the elements of an array by global indices: (i, j) is at
+     * data[(i + shift0) * stride0 + (j + shift1) * stride1].
+     */
+    template <typename T>
+    struct Frame
+    {
+        T * data;
+        ssize_t stride0;
+        ssize_t stride1;
+        ssize_t shift0;
+        ssize_t shift1;
+        T * locate(size_t i, size_t j) const
+        {
+            return data + (static_cast<ssize_t>(i) + shift0) * stride0 + (static_cast<ssize_t>(j) + shift1) * stride1;
+        }
+    }; /* end struct Frame */
+
+    /// The global array has no shift.
+    template <typename T, typename A>
+    Frame<T> global_frame(A & global) const
+    {
+        return Frame<T>{global.data(), static_cast<ssize_t>(global.stride(0)), 2 == ndim() ? static_cast<ssize_t>(global.stride(1)) : 0, 0, 0};
+    }
+
+    /// data() of block ib points at the first ghost, which is ghost() before the body.
+    template <typename T, typename A>
+    Frame<T> block_frame(A & block, size_t ib) const
+    {
+        return Frame<T>{
+            block.data(),
+            static_cast<ssize_t>(block.stride(0)),
+            2 == ndim() ? static_cast<ssize_t>(block.stride(1)) : 0,
+            static_cast<ssize_t>(ghost(0)) - static_cast<ssize_t>(offset(ib, 0)),
+            static_cast<ssize_t>(ghost(1)) - static_cast<ssize_t>(offset(ib, 1))};
+    }
+
+    template <typename T>
+    static void copy_box(Box const & box, Frame<T const> const & src, Frame<T> const & dst)
+    {
+        if (box.begin[0] >= box.end[0] || box.begin[1] >= box.end[1])
+        {
+            return;
+        }
+        size_t const ncol = box.end[1] - box.begin[1];
+        bool const contiguous = 1 == ncol || (1 == src.stride1 && 1 == dst.stride1);
+        for (size_t i = box.begin[0]; i < box.end[0]; ++i)
+        {
+            T const * srow = src.locate(i, box.begin[1]);
+            T * drow = dst.locate(i, box.begin[1]);
+            if (contiguous)
+            {
+                std::copy_n(srow, ncol, drow);
+            }
+            else
+            {
+                for (size_t j = 0; j < ncol; ++j)
+                {
+                    drow[static_cast<ssize_t>(j) * dst.stride1] = srow[static_cast<ssize_t>(j) * src.stride1];
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void check_global(SimpleArray<T> const & global) const
+    {
+        if (!(global.shape() == m_shape))
+        {
+            throw std::out_of_range("DomainDecomposition: shape mismatch of the global array");
+        }
+    }
+
+    template <typename T>
+    void check_blocks(std::vector<SimpleArray<T>> const & blocks) const
+    {
+        if (blocks.size() != nblock())
+        {
+            std::ostringstream ms;
+            ms << "DomainDecomposition: " << blocks.size() << " blocks for " << nblock() << " parts";
+            throw std::out_of_range(ms.str());
+        }
+    }
+
+    shape_type m_shape;
+    shape_type m_npart;
+    size_t m_nghost = 0;
+
+}; /* end class DomainDecomposition */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
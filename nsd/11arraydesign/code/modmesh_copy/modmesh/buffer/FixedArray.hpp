@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace modmesh
+{
+
+/**
+ * Fixed-rank view of the data of a SimpleArray for hot loops.  The rank ND is
+ * a template argument, the strides are held in a std::array, and the last
+ * dimension must have the unit stride, so that operator() compiles to a fixed
+ * number of multiply-adds and an inner loop over the last index vectorizes.
+ * When INNER is not 0, it is the compile-time extent of the last dimension.
+ *
+ * The view shares the buffer with the source array and indexes the same way
+ * (the first index counts from the body, after nghost cells).  Use T const to
+ * view a const array.  Taking a mutable view of a copy-on-write array detaches
+ * it once on construction and marks it as aliased, so that later copies do
+ * not share the buffer the view writes to.  to_simple() follows the aliases
+ * of SimpleArray: from a const view of a copy-on-write array it is
+ * copy-on-write too.
+ */
+template <typename T, size_t ND, size_t INNER = 0>
+class FixedArray
+{
+
+    static_assert(ND > 0, "FixedArray: rank must be positive");
+
+public:
+
+    using value_type = T;
+    using array_type = SimpleArray<std::remove_const_t<T>>;
+    using buffer_type = typename array_type::buffer_type;
+    using shape_type = std::array<size_t, ND>;
+
+    static constexpr size_t ndim() { return ND; }
+
+    explicit FixedArray(array_type & array)
+        : FixedArray(array.body(), array)
+    {
+    }
+
+    template <typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+    explicit FixedArray(array_type const & array)
+        : FixedArray(array.body(), array)
+    {
+    }
+
+    /// Turn back into a dynamic SimpleArray sharing the same buffer.
+    array_type to_simple() const
+    {
+        small_vector<size_t> shape(ND);
+        small_vector<size_t> stride(ND);
+        for (size_t it = 0; it < ND; ++it)
+        {
+            shape[it] = m_shape[it];
+            stride[it] = this->stride(it);
+        }
+        array_type ret(shape, stride, m_buffer);
+        ret.set_nghost(m_nghost);
+        ret.m_cow = m_cow;
+        return ret;
+    }
+
+    size_t shape(size_t it) const
+    {
+        if constexpr (INNER != 0)
+        {
+            if (ND - 1 == it)
+            {
+                return INNER;
+            }
+        }
+        return m_shape[it];
+    }
+    shape_type const & shape() const { return m_shape; }
+    size_t stride(size_t it) const { return ND - 1 == it ? 1 : m_stride[it]; }
+    size_t nghost() const { return m_nghost; }
+    size_t nbody() const { return m_shape[0] - m_nghost; }
+
+    value_type * body() const { return m_body; }
+    value_type * data() const { return m_body - m_nghost * stride(0); }
+
+    template <typename... Args>
+    value_type & operator()(Args... args) const
+    {
+        static_assert(sizeof...(Args) == ND, "FixedArray: number of indices must equal the rank");
+        ssize_t const idx[ND] = {static_cast<ssize_t>(args)...};
+        ssize_t offset = idx[ND - 1];
+        for (size_t it = 0; it < ND - 1; ++it)
+        {
+            offset += idx[it] * static_cast<ssize_t>(m_stride[it]);
+        }
+        return m_body[offset];
+    }
+
+private:
+
+    template <typename A>
+    FixedArray(value_type * body, A & array)
+        : m_buffer(std::const_pointer_cast<buffer_type>(array.buffer().shared_from_this()))
+        , m_body(body)
+        , m_nghost(array.nghost())
+        , m_cow(std::is_const_v<T> ? array.share_for_alias() : nullptr)
+    {
+        if (ND != array.ndim())
+        {
+            std::ostringstream ms;
+            ms << "FixedArray: rank " << ND << " != SimpleArray dimension " << array.ndim();
+            throw std::out_of_range(ms.str());
+        }
+        if (1 != array.stride(ND - 1) && 1 != array.shape(ND - 1))
+        {
+            std::ostringstream ms;
+            ms << "FixedArray: stride " << array.stride(ND - 1) << " of the last dimension is not 1";
+            throw std::out_of_range(ms.str());
+        }
+        if (INNER != 0 && INNER != array.shape(ND - 1))
+        {
+            std::ostringstream ms;
+            ms << "FixedArray: shape " << array.shape(ND - 1) << " of the last dimension != " << INNER;
+            throw std::out_of_range(ms.str());
+        }
+        for (size_t it = 0; it < ND; ++it)
+        {
+            m_shape[it] = array.shape(it);
+        }
+        for (size_t it = 0; it + 1 < ND; ++it)
+        {
+            m_stride[it] = array.stride(it);
+        }
+    }
+
+    std::shared_ptr<buffer_type> m_buffer;
+    value_type * m_body = nullptr;
+    shape_type m_shape{};
+    /// Strides of all but the last dimension, whose stride is 1.
+    std::array<size_t, ND == 1 ? 1 : ND - 1> m_stride{};
+    size_t m_nghost = 0;
+    /// Copy-on-write record of the const source array, for to_simple().
+    typename array_type::share_type m_cow;
+
+}; /* end class FixedArray */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,591 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Gather and scatter of SimpleArray rows by an index array, the "fancy
+ * indexing" of unstructured meshes:
+ *
+ *   take:        out[i] = src[idx[i]]
+ *   put:         dst[idx[i]] = values[i]
+ *   scatter_add: dst[idx[i]] += values[i]
+ *
+ * An index selects a row along the first dimension, and counts from the
+ * first body row like SimpleArray::operator(), so that the ghost rows have
+ * the negative indices [-nghost, 0).  A row is all the trailing dimensions.
+ * The indices are int32_t or int64_t and are all checked; an index out of
+ * bounds throws std::out_of_range, after put and scatter_add may have
+ * written part of the destination.
+ *
+ * take of 4- and 8-byte elements uses the AVX2 gather instructions.  put
+ * gives each thread a range of the destination rows to own, and every
+ * thread scans all the indices for its rows; the writes do not conflict and
+ * the last value of a duplicated index wins, as in the serial loop.
+ * scatter_add gives each thread a private copy of the destination to
+ * accumulate into, and sums the copies at the end.
+ */
+
+#include <modmesh/buffer/SimdKernel.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Options of take(), put() and scatter_add().
+ */
+struct GatherScatterOptions
+{
+    /// Number of threads; 0 uses std::thread::hardware_concurrency().
+    size_t nthread = 0;
+}; /* end struct GatherScatterOptions */
+
+namespace detail
+{
+
+/// Do not start a thread for less than this number of elements.
+inline constexpr size_t GATHER_GRAIN = 1 << 16;
+
+template <typename I>
+inline constexpr bool is_gather_index = std::is_same_v<I, int32_t> || std::is_same_v<I, int64_t>;
+
+template <typename T>
+inline constexpr bool gather_vectorizable = std::is_trivially_copyable_v<T> && (4 == sizeof(T) || 8 == sizeof(T));
+
+/**
+ * Copy the rows src[idx[i]] to out for i < n, where a row has row elements.
+ * Return the position of the first index outside [lo, hi), or n.
+ */
+template <typename T, typename I>
+size_t take_rows_scalar(T const * src, ssize_t lo, ssize_t hi, size_t row, I const * idx, size_t n, T * out)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        ssize_t const k = static_cast<ssize_t>(idx[i]);
+        if (k < lo || k >= hi)
+        {
+            return i;
+        }
+        if (1 == row)
+        {
+            out[i] = src[k];
+        }
+        else
+        {
+            std::copy_n(src + k * static_cast<ssize_t>(row), row, out + i * row);
+        }
+    }
+    return n;
+}
+
+#if MODMESH_SIMD_X86
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+// The unmasked gather intrinsics pass an undefined source vector.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace simd_avx2
+{
+
+/// Test the lanes of 32-bit indices against [lo, hi).
+inline bool in_bounds(__m256i v, __m256i lo, __m256i last)
+{
+    __m256i const bad = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, last));
+    return _mm256_testz_si256(bad, bad);
+}
+
+inline bool in_bounds(__m128i v, __m128i lo, __m128i last)
+{
+    __m128i const bad = _mm_or_si128(_mm_cmpgt_epi32(lo, v), _mm_cmpgt_epi32(v, last));
+    return _mm_testz_si128(bad, bad);
+}
+
+/// Test the lanes of 64-bit indices against [lo, hi).
+inline bool in_bounds64(__m256i v, __m256i lo, __m256i last)
+{
+    __m256i const bad = _mm256_or_si256(_mm256_cmpgt_epi64(lo, v), _mm256_cmpgt_epi64(v, last));
+    return _mm256_testz_si256(bad, bad);
+}
+
+/**
+ * Gather single elements (a row of 1) with vgather, a vector of indices at a
+ * time.  A vector with an index out of bounds is left to the scalar loop to
+ * report.
+ */
+template <typename T, typename I>
+size_t take_rows(T const * src, ssize_t lo, ssize_t hi, size_t row, I const * idx, size_t n, T * out)
+{
+    if (1 != row)
+    {
+        return take_rows_scalar(src, lo, hi, row, idx, n, out);
+    }
+    size_t i = 0;
+    if constexpr (std::is_same_v<I, int32_t>)
+    {
+        // Only the indices that fit in I can be in bounds.
+        int32_t const lo32 = static_cast<int32_t>(std::max(lo, ssize_t(std::numeric_limits<int32_t>::min())));
+        int32_t const last32 = static_cast<int32_t>(std::min(hi - 1, ssize_t(std::numeric_limits<int32_t>::max())));
+        if constexpr (4 == sizeof(T))
+        {
+            auto const * s = reinterpret_cast<float const *>(src);
+            __m256i const vlo = _mm256_set1_epi32(lo32);
+            __m256i const vlast = _mm256_set1_epi32(last32);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(idx + i));
+                if (!in_bounds(v, vlo, vlast))
+                {
+                    break;
+                }
+                _mm256_storeu_ps(reinterpret_cast<float *>(out + i), _mm256_i32gather_ps(s, v, 4));
+            }
+        }
+        else
+        {
+            auto const * s = reinterpret_cast<double const *>(src);
+            __m128i const vlo = _mm_set1_epi32(lo32);
+            __m128i const vlast = _mm_set1_epi32(last32);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(idx + i));
+                if (!in_bounds(v, vlo, vlast))
+                {
+                    break;
+                }
+                _mm256_storeu_pd(reinterpret_cast<double *>(out + i), _mm256_i32gather_pd(s, v, 8));
+            }
+        }
+    }
+    else
+    {
+        __m256i const vlo = _mm256_set1_epi64x(static_cast<long long>(lo));
+        __m256i const vlast = _mm256_set1_epi64x(static_cast<long long>(hi - 1));
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(idx + i));
+            if (!in_bounds64(v, vlo, vlast))
+            {
+                break;
+            }
+            if constexpr (4 == sizeof(T))
+            {
+                auto const * s = reinterpret_cast<float const *>(src);
+                _mm_storeu_ps(reinterpret_cast<float *>(out + i), _mm256_i64gather_ps(s, v, 4));
+            }
+            else
+            {
+                auto const * s = reinterpret_cast<double const *>(src);
+                _mm256_storeu_pd(reinterpret_cast<double *>(out + i), _mm256_i64gather_pd(s, v, 8));
+            }
+        }
+    }
+    return i + take_rows_scalar(src, lo, hi, row, idx + i, n - i, out + i);
+}
+
+} /* end namespace simd_avx2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+#endif // MODMESH_SIMD_X86
+
+template <typename T, typename I>
+using take_rows_type = size_t (*)(T const *, ssize_t, ssize_t, size_t, I const *, size_t, T *);
+
+/// The take kernel of type T for the SimdLevel.
+template <typename T, typename I>
+take_rows_type<T, I> take_rows_kernel(SimdLevel level)
+{
+#if MODMESH_SIMD_X86
+    if constexpr (gather_vectorizable<T>)
+    {
+        if (level >= SimdLevel::AVX2)
+        {
+            return &simd_avx2::take_rows<T, I>;
+        }
+    }
+#else
+    (void)level;
+#endif
+    return &take_rows_scalar<T, I>;
+}
+
+/**
+ * Run work(ithread, nthread) on nthread threads for nelem elements of work,
+ * and return the smallest value returned by work.
+ */
+template <typename W>
+size_t gather_parallel(size_t nthread, size_t nelem, W && work)
+{
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nthread = std::max(std::min(nthread, (nelem + GATHER_GRAIN - 1) / GATHER_GRAIN), size_t(1));
+
+    std::vector<size_t> result(nthread);
+    auto run = [&](size_t ithread)
+    { result[ithread] = work(ithread, nthread); };
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (size_t it = 1; it < nthread; ++it)
+    {
+        threads.emplace_back(run, it);
+    }
+    run(0);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    return *std::min_element(result.begin(), result.end());
+}
+
+template <typename T>
+size_t gather_row_size(SimpleArray<T> const & arr)
+{
+    size_t row = 1;
+    for (size_t it = 1; it < arr.ndim(); ++it)
+    {
+        row *= arr.shape(it);
+    }
+    return row;
+}
+
+/// Return arr itself when C-contiguous, or a C-contiguous copy in tmp.
+template <typename T>
+SimpleArray<T> const & gather_contiguous(SimpleArray<T> const & arr, SimpleArray<T> & tmp)
+{
+    if (arr.is_c_contiguous())
+    {
+        return arr;
+    }
+    tmp = arr.to_layout(ArrayLayout::C);
+    return tmp;
+}
+
+template <typename T, typename I>
+void gather_throw_index(char const * name, SimpleArray<T> const & arr, I index)
+{
+    std::ostringstream ms;
+    ms << "SimpleArray: " << name << " index " << index << " out of bounds [" << -static_cast<ssize_t>(arr.nghost())
+       << ", " << arr.nbody() << ")";
+    throw std::out_of_range(ms.str());
+}
+
+/// Check the destination and the values of put() and scatter_add().
+template <typename T, typename I>
+void scatter_check(char const * name, SimpleArray<T> const & dst, SimpleArray<I> const & idx, SimpleArray<T> const & values)
+{
+    static_assert(is_gather_index<I>, "index type must be int32_t or int64_t");
+    if (0 == dst.ndim())
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: " << name << " into a 0-dimensional array";
+        throw std::out_of_range(ms.str());
+    }
+    if (!dst.is_c_contiguous())
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: " << name << " needs a C-contiguous destination";
+        throw std::runtime_error(ms.str());
+    }
+    small_vector<size_t> shape = idx.shape();
+    for (size_t it = 1; it < dst.ndim(); ++it)
+    {
+        shape.push_back(dst.shape(it));
+    }
+    if (!(values.shape() == shape))
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: " << name << " values of shape ";
+        print_broadcast_shape(ms, values.shape());
+        ms << " differ from the indexed shape ";
+        print_broadcast_shape(ms, shape);
+        throw std::out_of_range(ms.str());
+    }
+}
+
+} /* end namespace detail */
+
+/**
+ * Write the rows src[idx[i]] into out, whose shape must be idx.shape()
+ * followed by the trailing dimensions of src.
+ */
+template <typename T, typename I>
+void take(SimpleArray<T> const & src, SimpleArray<I> const & idx, SimpleArray<T> & out, GatherScatterOptions const & options = {})
+{
+    static_assert(detail::is_gather_index<I>, "index type must be int32_t or int64_t");
+    if (0 == src.ndim())
+    {
+        throw std::out_of_range("SimpleArray: take from a 0-dimensional array");
+    }
+    small_vector<size_t> shape = idx.shape();
+    for (size_t it = 1; it < src.ndim(); ++it)
+    {
+        shape.push_back(src.shape(it));
+    }
+    if (!(out.shape() == shape) || !out.is_c_contiguous())
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: take output of shape ";
+        detail::print_broadcast_shape(ms, out.shape());
+        ms << " is not C-contiguous of the indexed shape ";
+        detail::print_broadcast_shape(ms, shape);
+        throw std::out_of_range(ms.str());
+    }
+
+    SimpleArray<T> tmp_src;
+    SimpleArray<I> tmp_idx;
+    SimpleArray<T> const & csrc = detail::gather_contiguous(src, tmp_src);
+    SimpleArray<I> const & cidx = detail::gather_contiguous(idx, tmp_idx);
+    size_t const n = detail::simd_nelem(cidx);
+    size_t const row = detail::gather_row_size(csrc);
+    if (0 == n || 0 == row)
+    {
+        return;
+    }
+    ssize_t const lo = -static_cast<ssize_t>(csrc.nghost());
+    ssize_t const hi = static_cast<ssize_t>(csrc.nbody());
+    T const * body = csrc.body();
+    I const * pidx = cidx.data();
+    T * pout = out.data();
+    auto const kernel = detail::take_rows_kernel<T, I>(SimdDispatch::me().level());
+
+    size_t const bad = detail::gather_parallel(
+        options.nthread,
+        n * row,
+        [&](size_t ithread, size_t nthread)
+        {
+            size_t const begin = n * ithread / nthread;
+            size_t const end = n * (ithread + 1) / nthread;
+            size_t const pos = kernel(body, lo, hi, row, pidx + begin, end - begin, pout + begin * row);
+            return pos < end - begin ? begin + pos : n;
+        });
+    if (bad < n)
+    {
+        detail::gather_throw_index("take", csrc, pidx[bad]);
+    }
+}
+
+/**
+ * Return the rows src[idx[i]] in a new array of the shape idx.shape()
+ * followed by the trailing dimensions of src, like numpy.take along axis 0.
+ */
+template <typename T, typename I>
+SimpleArray<T> take(SimpleArray<T> const & src, SimpleArray<I> const & idx, GatherScatterOptions const & options = {})
+{
+    small_vector<size_t> shape = idx.shape();
+    for (size_t it = 1; it < src.ndim(); ++it)
+    {
+        shape.push_back(src.shape(it));
+    }
+    SimpleArray<T> ret(shape, src.alignment());
+    take(src, idx, ret, options);
+    return ret;
+}
+
+/**
+ * Write values[i] into the rows dst[idx[i]].  values has the shape
+ * idx.shape() followed by the trailing dimensions of dst.  For a duplicated
+ * index the last value wins.
+ */
+template <typename T, typename I>
+void put(SimpleArray<T> & dst, SimpleArray<I> const & idx, SimpleArray<T> const & values, GatherScatterOptions const & options = {})
+{
+    detail::scatter_check("put", dst, idx, values);
+    SimpleArray<I> tmp_idx;
+    SimpleArray<T> tmp_values;
+    SimpleArray<I> const & cidx = detail::gather_contiguous(idx, tmp_idx);
+    SimpleArray<T> const & cvalues = detail::gather_contiguous(values, tmp_values);
+    size_t const n = detail::simd_nelem(cidx);
+    size_t const row = detail::gather_row_size(dst);
+    if (0 == n || 0 == row)
+    {
+        return;
+    }
+    ssize_t const lo = -static_cast<ssize_t>(dst.nghost());
+    ssize_t const hi = static_cast<ssize_t>(dst.nbody());
+    T * body = dst.body(); // Detach copy-on-write before reading the values.
+    I const * pidx = cidx.data();
+    T const * pvalues = cvalues.data();
+
+    size_t const bad = detail::gather_parallel(
+        options.nthread,
+        n * row,
+        [&](size_t ithread, size_t nthread)
+        {
+            // The rows [own_lo, own_hi) belong to this thread.
+            ssize_t const nrow = hi - lo;
+            ssize_t const own_lo = lo + nrow * static_cast<ssize_t>(ithread) / static_cast<ssize_t>(nthread);
+            ssize_t const own_hi = lo + nrow * static_cast<ssize_t>(ithread + 1) / static_cast<ssize_t>(nthread);
+            for (size_t i = 0; i < n; ++i)
+            {
+                ssize_t const k = static_cast<ssize_t>(pidx[i]);
+                if (k < lo || k >= hi)
+                {
+                    return i;
+                }
+                if (k >= own_lo && k < own_hi)
+                {
+                    std::copy_n(pvalues + i * row, row, body + k * static_cast<ssize_t>(row));
+                }
+            }
+            return n;
+        });
+    if (bad < n)
+    {
+        detail::gather_throw_index("put", dst, pidx[bad]);
+    }
+}
+
+/**
+ * Add values[i] to the rows dst[idx[i]], accumulating over duplicated
+ * indices like numpy.add.at.  values has the shape idx.shape() followed by
+ * the trailing dimensions of dst.
+ *
+ * Each thread accumulates into a private copy of the destination, so the
+ * number of threads is limited to keep the copies no larger than the values.
+ * With more than one thread the sums are in a different order from the
+ * serial loop, and floating-point results may differ in the last bits.
+ */
+template <typename T, typename I>
+void scatter_add(SimpleArray<T> & dst, SimpleArray<I> const & idx, SimpleArray<T> const & values, GatherScatterOptions const & options = {})
+{
+    detail::scatter_check("scatter_add", dst, idx, values);
+    SimpleArray<I> tmp_idx;
+    SimpleArray<T> tmp_values;
+    SimpleArray<I> const & cidx = detail::gather_contiguous(idx, tmp_idx);
+    SimpleArray<T> const & cvalues = detail::gather_contiguous(values, tmp_values);
+    size_t const n = detail::simd_nelem(cidx);
+    size_t const row = detail::gather_row_size(dst);
+    if (0 == n || 0 == row)
+    {
+        return;
+    }
+    ssize_t const lo = -static_cast<ssize_t>(dst.nghost());
+    ssize_t const hi = static_cast<ssize_t>(dst.nbody());
+    size_t const ndst = dst.shape(0) * row;
+    T * body = dst.body(); // Detach copy-on-write before reading the values.
+    I const * pidx = cidx.data();
+    T const * pvalues = cvalues.data();
+
+    size_t nthread = options.nthread;
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nthread = std::max(std::min(nthread, n * row / ndst), size_t(1));
+
+    // Thread 0 adds into dst; the others into their own zero-filled copies.
+    std::vector<std::vector<T>> privates(nthread);
+    size_t const bad = detail::gather_parallel(
+        nthread,
+        n * row,
+        [&](size_t ithread, size_t nthread_used)
+        {
+            size_t const begin = n * ithread / nthread_used;
+            size_t const end = n * (ithread + 1) / nthread_used;
+            T * acc = body;
+            if (0 != ithread)
+            {
+                privates[ithread].assign(ndst, T(0));
+                acc = privates[ithread].data() - lo * static_cast<ssize_t>(row);
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                ssize_t const k = static_cast<ssize_t>(pidx[i]);
+                if (k < lo || k >= hi)
+                {
+                    return i;
+                }
+                T * target = acc + k * static_cast<ssize_t>(row);
+                T const * source = pvalues + i * row;
+                for (size_t j = 0; j < row; ++j)
+                {
+                    target[j] += source[j];
+                }
+            }
+            return n;
+        });
+    if (bad < n)
+    {
+        detail::gather_throw_index("scatter_add", dst, pidx[bad]);
+    }
+
+    // Sum the private copies into dst, each thread over a range of it.
+    T * origin = body + lo * static_cast<ssize_t>(row);
+    size_t const nprivate = std::count_if(privates.begin(), privates.end(), [](auto const & p)
+                                          { return !p.empty(); });
+    if (0 == nprivate)
+    {
+        return;
+    }
+    detail::gather_parallel(
+        nthread,
+        ndst * nprivate,
+        [&](size_t ithread, size_t nthread_used)
+        {
+            size_t const begin = ndst * ithread / nthread_used;
+            size_t const end = ndst * (ithread + 1) / nthread_used;
+            for (std::vector<T> const & p : privates)
+            {
+                if (!p.empty())
+                {
+                    for (size_t j = begin; j < end; ++j)
+                    {
+                        origin[j] += p[j];
+                    }
+                }
+            }
+            return size_t(0);
+        });
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,345 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Iterate over N-dimensional strided arrays of the same shape together, one
+ * inner loop at a time, like numpy.nditer with the external loop.
+ *
+ * The dimensions are reordered by the strides of the first operand, from the
+ * largest to the smallest, and the dimensions of length 1 are dropped.  Then
+ * each dimension contiguous with the inner one in every operand is collapsed
+ * into it.  Contiguous arrays, in either C or Fortran order, therefore go
+ * through a single inner loop of all the elements, and the kernel sees the
+ * longest unit-stride runs the layout allows.
+ *
+ * The inner loops are numbered in the order of the outer dimensions, so that
+ * a range of them can be given to a thread.
+ */
+
+#include <modmesh/buffer/small_vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <BaseTsd.h>
+typedef SSIZE_T ssize_t;
+#endif
+
+namespace modmesh
+{
+
+template <typename T>
+class SimpleArray;
+
+template <typename... Ts>
+class NdIter
+{
+
+public:
+
+    static constexpr size_t NOP = sizeof...(Ts);
+    /// Dimensions kept without heap allocation, as in SimpleArray.
+    static constexpr size_t INLINE_NDIM = 6;
+    using shape_type = small_vector<size_t, INLINE_NDIM>;
+    using sshape_type = small_vector<ssize_t, INLINE_NDIM>;
+    /// Strides of the operands along a dimension, counted in elements.
+    using stride_type = std::array<ssize_t, NOP>;
+    using pointer_type = std::tuple<Ts *...>;
+
+    static_assert(NOP > 0, "NdIter needs at least one operand");
+
+    /**
+     * Iterate over the block of shape at data, where operand i has the
+     * element strides strides[i].  A stride may be 0 to repeat an operand
+     * along a dimension, or negative.
+     */
+    NdIter(shape_type const & shape, std::array<sshape_type, NOP> const & strides, Ts *... data)
+        : m_base(data...)
+    {
+        // Sort the dimensions by the stride of the first operand, largest first.
+        shape_type order(shape.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(
+            order.begin(),
+            order.end(),
+            [&](size_t a, size_t b)
+            { return std::abs(strides[0][a]) > std::abs(strides[0][b]); });
+
+        for (size_t it = 0; it < shape.size(); ++it)
+        {
+            size_t const axis = order[it];
+            if (0 == shape[axis])
+            {
+                m_shape = shape_type{0};
+                m_stride = small_vector<stride_type, INLINE_NDIM>(1, stride_type{});
+                break;
+            }
+            if (1 == shape[axis])
+            {
+                continue;
+            }
+            stride_type stride;
+            for (size_t iop = 0; iop < NOP; ++iop)
+            {
+                stride[iop] = strides[iop][axis];
+            }
+            // Collapse into the previous (outer) dimension when it steps over exactly this one.
+            if (!m_shape.empty() && collapsible(m_stride[m_shape.size() - 1], stride, shape[axis]))
+            {
+                m_shape[m_shape.size() - 1] *= shape[axis];
+                m_stride[m_shape.size() - 1] = stride;
+            }
+            else
+            {
+                m_shape.push_back(shape[axis]);
+                m_stride.push_back(stride);
+            }
+        }
+        if (m_shape.empty())
+        {
+            // A single element.
+            m_shape = shape_type{1};
+            m_stride = small_vector<stride_type, INLINE_NDIM>(1, stride_type{});
+        }
+
+        m_nouter = 1;
+        for (size_t it = 0; it + 1 < m_shape.size(); ++it)
+        {
+            m_nouter *= m_shape[it];
+        }
+        m_nouter = 0 == inner_size() ? 0 : m_nouter;
+        m_index = shape_type(m_shape.size() - 1, 0);
+        m_end = m_nouter;
+        m_ptr = m_base;
+    }
+
+    /// Number of dimensions after dropping and collapsing.
+    size_t ndim() const { return m_shape.size(); }
+    shape_type const & shape() const { return m_shape; }
+    /// Number of elements of an inner loop.
+    size_t inner_size() const { return m_shape[m_shape.size() - 1]; }
+    stride_type const & inner_stride() const { return m_stride[m_shape.size() - 1]; }
+    /// Number of inner loops of the whole block.
+    size_t nouter() const { return m_nouter; }
+    size_t size() const { return m_nouter * inner_size(); }
+
+    /// Index of the current inner loop.
+    size_t position() const { return m_pos; }
+    bool done() const { return m_pos >= m_end; }
+    pointer_type const & data() const { return m_ptr; }
+    template <size_t I>
+    auto ptr() const { return std::get<I>(m_ptr); }
+
+    /// Move to the next inner loop.
+    void next()
+    {
+        ++m_pos;
+        for (size_t dim = m_index.size(); dim > 0; --dim)
+        {
+            size_t const axis = dim - 1;
+            ++m_index[axis];
+            advance(m_stride[axis], 1);
+            if (m_index[axis] < m_shape[axis])
+            {
+                return;
+            }
+            advance(m_stride[axis], -static_cast<ssize_t>(m_shape[axis]));
+            m_index[axis] = 0;
+        }
+    }
+
+    /// Return an iterator over the inner loops [begin, end) of this block.
+    NdIter slice(size_t begin, size_t end) const
+    {
+        NdIter ret(*this);
+        ret.m_end = std::min(end, m_nouter);
+        ret.m_pos = std::min(begin, ret.m_end);
+        ret.m_ptr = m_base;
+        size_t rest = ret.m_pos;
+        for (size_t dim = m_index.size(); dim > 0; --dim)
+        {
+            size_t const axis = dim - 1;
+            ret.m_index[axis] = rest % m_shape[axis];
+            rest /= m_shape[axis];
+            ret.advance(m_stride[axis], static_cast<ssize_t>(ret.m_index[axis]));
+        }
+        return ret;
+    }
+
+    /**
+     * Call kernel(count, stride, ptr...) for each remaining inner loop, where
+     * stride is the stride_type of the inner loop and there is a pointer for
+     * each operand.
+     */
+    template <typename K>
+    void for_each(K && kernel)
+    {
+        for (; !done(); next())
+        {
+            call(kernel, std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    /**
+     * Split the inner loops over threads and call for_each on each part.
+     * Operands written by the kernel must not overlap across the parts.
+     */
+    template <typename K>
+    void parallel_for_each(K && kernel, size_t nthread = 0) const
+    {
+        if (0 == nthread)
+        {
+            nthread = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        size_t const ntask = m_end - std::min(m_pos, m_end);
+        size_t const ngrain = std::max((ntask * inner_size()) / NDITER_GRAIN, size_t(1));
+        nthread = std::max(std::min({nthread, ntask, ngrain}), size_t(1));
+        auto work = [&](size_t ithread)
+        {
+            size_t const begin = m_pos + ntask * ithread / nthread;
+            size_t const end = m_pos + ntask * (ithread + 1) / nthread;
+            slice(begin, end).for_each(kernel);
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(nthread - 1);
+        for (size_t it = 1; it < nthread; ++it)
+        {
+            threads.emplace_back(work, it);
+        }
+        work(0);
+        for (std::thread & thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    /// Do not start a thread for less than this number of elements.
+    static constexpr size_t NDITER_GRAIN = 1 << 16;
+
+private:
+
+    static bool collapsible(stride_type const & outer, stride_type const & inner, size_t extent)
+    {
+        for (size_t iop = 0; iop < NOP; ++iop)
+        {
+            if (outer[iop] != inner[iop] * static_cast<ssize_t>(extent))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void advance(stride_type const & stride, ssize_t count)
+    {
+        advance_impl(stride, count, std::index_sequence_for<Ts...>{});
+    }
+
+    template <size_t... I>
+    void advance_impl(stride_type const & stride, ssize_t count, std::index_sequence<I...>)
+    {
+        ((std::get<I>(m_ptr) += stride[I] * count), ...);
+    }
+
+    template <typename K, size_t... I>
+    void call(K & kernel, std::index_sequence<I...>)
+    {
+        kernel(inner_size(), inner_stride(), std::get<I>(m_ptr)...);
+    }
+
+    shape_type m_shape;
+    small_vector<stride_type, INLINE_NDIM> m_stride;
+    pointer_type m_base;
+    pointer_type m_ptr;
+    /// Index of the outer dimensions of the current inner loop.
+    shape_type m_index;
+    size_t m_nouter = 0;
+    size_t m_pos = 0;
+    size_t m_end = 0;
+
+}; /* end class NdIter */
+
+namespace detail
+{
+
+template <typename A>
+struct nditer_operand;
+
+template <typename T>
+struct nditer_operand<SimpleArray<T>>
+{
+    using type = T;
+};
+
+template <typename T>
+struct nditer_operand<SimpleArray<T> const>
+{
+    using type = T const;
+};
+
+} /* end namespace detail */
+
+/**
+ * Iterate over SimpleArray of the same shape, including the ghost elements.
+ * A const array is read-only in the kernel.
+ */
+template <typename... As>
+NdIter<typename detail::nditer_operand<As>::type...> make_nditer(As &... arrays)
+{
+    using iter_type = NdIter<typename detail::nditer_operand<As>::type...>;
+    auto const & first = std::get<0>(std::forward_as_tuple(arrays...));
+    if (!((arrays.shape() == first.shape()) && ...))
+    {
+        throw std::out_of_range("NdIter: shape mismatch");
+    }
+    auto stride_of = [](auto const & arr)
+    {
+        typename iter_type::sshape_type ret(arr.ndim());
+        for (size_t it = 0; it < arr.ndim(); ++it)
+        {
+            ret[it] = static_cast<ssize_t>(arr.stride(it));
+        }
+        return ret;
+    };
+    return iter_type(first.shape(), {stride_of(arrays)...}, arrays.data()...);
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
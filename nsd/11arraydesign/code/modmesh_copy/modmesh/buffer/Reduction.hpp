@@ -0,0 +1,392 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <modmesh/buffer/SimdKernel.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Options of the reductions in namespace reduce.
+ */
+struct ReduceOptions
+{
+    /// Number of threads; 0 uses std::thread::hardware_concurrency().
+    size_t nthread = 0;
+    /**
+     * Sum the per-block partials along a fixed pairwise tree so that the
+     * floating-point result does not depend on the number of threads.
+     */
+    bool deterministic = false;
+}; /* end struct ReduceOptions */
+
+namespace detail
+{
+
+/*
+ * The data are cut into blocks of a fixed length.  The SIMD kernels run on a
+ * block at a time, and a block is small enough for the scratch buffer of the
+ * multi-pass reductions to stay in L1 cache.
+ */
+inline constexpr size_t REDUCE_BLOCK = 2048;
+/**
+ * Do not start a thread for less than this number of elements.  The threads
+ * are started for each call, which costs tens of microseconds; a thread
+ * needs about this much work, a couple of MB, to make up for it.  Smaller
+ * arrays, like the residuals of an iterative solver, reduce serially in the
+ * calling thread.
+ */
+inline constexpr size_t REDUCE_GRAIN = 1 << 18;
+
+inline size_t reduce_nthread(size_t nelem, ReduceOptions const & options)
+{
+    size_t nthread = options.nthread;
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    return std::max(std::min(nthread, (nelem + REDUCE_GRAIN - 1) / REDUCE_GRAIN), size_t(1));
+}
+
+/**
+ * Apply block(begin, end) on every block and fold the results with combine.
+ * Each thread takes a contiguous range of blocks.  In the deterministic mode
+ * every block result is kept and folded pairwise in a tree fixed by the
+ * number of blocks; otherwise each thread folds its own blocks and the
+ * per-thread partials are folded in order.
+ */
+template <typename R, typename B, typename C>
+R parallel_reduce(size_t nelem, R init, B && block, C && combine, ReduceOptions const & options)
+{
+    size_t const nblock = (nelem + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    if (0 == nblock)
+    {
+        return init;
+    }
+    size_t const nthread = reduce_nthread(nelem, options);
+
+    std::vector<R> partials(options.deterministic ? nblock : nthread, init);
+    auto work = [&](size_t ithread)
+    {
+        size_t const bbegin = nblock * ithread / nthread;
+        size_t const bend = nblock * (ithread + 1) / nthread;
+        R acc = init;
+        for (size_t ib = bbegin; ib < bend; ++ib)
+        {
+            R const val = block(ib * REDUCE_BLOCK, std::min((ib + 1) * REDUCE_BLOCK, nelem));
+            if (options.deterministic)
+            {
+                partials[ib] = val;
+            }
+            else
+            {
+                acc = combine(acc, val);
+            }
+        }
+        if (!options.deterministic)
+        {
+            partials[ithread] = acc;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (size_t it = 1; it < nthread; ++it)
+    {
+        threads.emplace_back(work, it);
+    }
+    work(0);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    if (options.deterministic)
+    {
+        for (size_t width = 1; width < partials.size(); width *= 2)
+        {
+            for (size_t it = 0; it + width < partials.size(); it += 2 * width)
+            {
+                partials[it] = combine(partials[it], partials[it + width]);
+            }
+        }
+        return partials[0];
+    }
+    R ret = partials[0];
+    for (size_t it = 1; it < partials.size(); ++it)
+    {
+        ret = combine(ret, partials[it]);
+    }
+    return ret;
+}
+
+template <typename T>
+void reduce_check(char const * name, SimpleArray<T> const & arr)
+{
+    if (!arr.is_c_contiguous())
+    {
+        std::ostringstream ms;
+        ms << "reduce::" << name << ": array must be C-contiguous";
+        throw std::runtime_error(ms.str());
+    }
+}
+
+template <typename T>
+void reduce_check_nonempty(char const * name, SimpleArray<T> const & arr)
+{
+    reduce_check(name, arr);
+    if (0 == simd_nelem(arr))
+    {
+        std::ostringstream ms;
+        ms << "reduce::" << name << ": empty array";
+        throw std::runtime_error(ms.str());
+    }
+}
+
+template <typename T>
+void reduce_check_pair(char const * name, SimpleArray<T> const & arr0, SimpleArray<T> const & arr1)
+{
+    reduce_check(name, arr0);
+    reduce_check(name, arr1);
+    if (!(arr0.shape() == arr1.shape()))
+    {
+        std::ostringstream ms;
+        ms << "reduce::" << name << ": shape mismatch";
+        throw std::runtime_error(ms.str());
+    }
+}
+
+/// The value and the flat index of an extremum.
+template <typename T>
+struct ArgValue
+{
+    T value;
+    size_t index;
+}; /* end struct ArgValue */
+
+template <typename T, bool IS_MAX>
+ArgValue<T> reduce_arg(SimpleArray<T> const & arr, ReduceOptions const & options)
+{
+    T const * data = arr.data();
+    SimdKernelTable<T> const & kernels = simd_kernel_table<T>();
+    auto block = [&](size_t begin, size_t end)
+    {
+        // Find the extremum with SIMD and then its first position in the
+        // block, which is still in cache.
+        T const value = IS_MAX ? kernels.amax(data + begin, end - begin) : kernels.amin(data + begin, end - begin);
+        size_t index = begin;
+        while (index + 1 < end && data[index] != value)
+        {
+            ++index;
+        }
+        return ArgValue<T>{value, index};
+    };
+    auto combine = [](ArgValue<T> const & lhs, ArgValue<T> const & rhs)
+    {
+        // The earlier index wins a tie.
+        bool const take_rhs = IS_MAX ? rhs.value > lhs.value : rhs.value < lhs.value;
+        return (take_rhs || (rhs.value == lhs.value && rhs.index < lhs.index)) ? rhs : lhs;
+    };
+    ArgValue<T> const init{data[0], 0};
+    return parallel_reduce(simd_nelem(arr), init, block, combine, options);
+}
+
+/**
+ * Reduce the elementwise transform of one or two arrays.  The transform
+ * writes a block into a scratch buffer with the SIMD kernels, and the buffer
+ * is then summed (IS_SUM) or taken the maximum.
+ */
+template <typename T, bool IS_SUM, typename F>
+T reduce_transformed(size_t nelem, F && transform, ReduceOptions const & options)
+{
+    SimdKernelTable<T> const & kernels = simd_kernel_table<T>();
+    auto block = [&](size_t begin, size_t end)
+    {
+        T buf[REDUCE_BLOCK];
+        transform(kernels, begin, end - begin, buf);
+        return IS_SUM ? kernels.sum(buf, end - begin) : kernels.amax(buf, end - begin);
+    };
+    auto combine = [](T lhs, T rhs)
+    { return IS_SUM ? lhs + rhs : std::max(lhs, rhs); };
+    return parallel_reduce(nelem, T(0), block, combine, options);
+}
+
+template <typename T, bool IS_SUM, bool IS_SQUARE>
+T reduce_norm(T const * data0, T const * data1, size_t nelem, ReduceOptions const & options)
+{
+    auto transform = [&](SimdKernelTable<T> const & kernels, size_t begin, size_t length, T * buf)
+    {
+        T const * src = data0 + begin;
+        if (nullptr != data1)
+        {
+            if constexpr (std::is_unsigned_v<T>)
+            {
+                // The difference of unsigned values wraps and abs() does not
+                // undo it, so take max - min.
+                T lo[REDUCE_BLOCK];
+                kernels.max(src, data1 + begin, buf, length);
+                kernels.min(src, data1 + begin, lo, length);
+                kernels.sub(buf, lo, buf, length);
+            }
+            else
+            {
+                kernels.sub(src, data1 + begin, buf, length);
+            }
+            src = buf;
+        }
+        if (IS_SQUARE)
+        {
+            kernels.mul(src, src, buf, length);
+        }
+        else
+        {
+            kernels.abs(src, buf, length);
+        }
+    };
+    return reduce_transformed<T, IS_SUM>(nelem, transform, options);
+}
+
+} /* end namespace detail */
+
+/*
+ * Reductions over C-contiguous SimpleArray.  The work is split among threads
+ * by blocks, and each block is done with the SIMD kernels (SimdKernel.hpp).
+ * The extrema are exact and do not depend on the threads.  The sums may, in
+ * the last bits, unless ReduceOptions::deterministic is set.
+ */
+namespace reduce
+{
+
+template <typename T>
+T sum(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check("sum", arr);
+    T const * data = arr.data();
+    detail::SimdKernelTable<T> const & kernels = detail::simd_kernel_table<T>();
+    return detail::parallel_reduce(
+        detail::simd_nelem(arr),
+        T(0),
+        [&](size_t begin, size_t end)
+        { return kernels.sum(data + begin, end - begin); },
+        [](T lhs, T rhs)
+        { return lhs + rhs; },
+        options);
+}
+
+template <typename T>
+T min(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check_nonempty("min", arr);
+    return detail::reduce_arg<T, false>(arr, options).value;
+}
+
+template <typename T>
+T max(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check_nonempty("max", arr);
+    return detail::reduce_arg<T, true>(arr, options).value;
+}
+
+/// The flat index of the first minimum.
+template <typename T>
+size_t argmin(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check_nonempty("argmin", arr);
+    return detail::reduce_arg<T, false>(arr, options).index;
+}
+
+/// The flat index of the first maximum.
+template <typename T>
+size_t argmax(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check_nonempty("argmax", arr);
+    return detail::reduce_arg<T, true>(arr, options).index;
+}
+
+/// The maximum absolute value (the infinity norm).
+template <typename T>
+T amax(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check("amax", arr);
+    return detail::reduce_norm<T, false, false>(arr.data(), nullptr, detail::simd_nelem(arr), options);
+}
+
+/// The L1 norm: the sum of the absolute values.
+template <typename T>
+T norm1(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check("norm1", arr);
+    return detail::reduce_norm<T, true, false>(arr.data(), nullptr, detail::simd_nelem(arr), options);
+}
+
+/// The L2 norm.
+template <typename T>
+T norm2(SimpleArray<T> const & arr, ReduceOptions const & options = {})
+{
+    detail::reduce_check("norm2", arr);
+    return std::sqrt(detail::reduce_norm<T, true, true>(arr.data(), nullptr, detail::simd_nelem(arr), options));
+}
+
+/// The maximum absolute difference between two arrays.
+template <typename T>
+T diff_amax(SimpleArray<T> const & arr0, SimpleArray<T> const & arr1, ReduceOptions const & options = {})
+{
+    detail::reduce_check_pair("diff_amax", arr0, arr1);
+    return detail::reduce_norm<T, false, false>(arr0.data(), arr1.data(), detail::simd_nelem(arr0), options);
+}
+
+/// The L1 norm of the difference between two arrays.
+template <typename T>
+T diff_norm1(SimpleArray<T> const & arr0, SimpleArray<T> const & arr1, ReduceOptions const & options = {})
+{
+    detail::reduce_check_pair("diff_norm1", arr0, arr1);
+    return detail::reduce_norm<T, true, false>(arr0.data(), arr1.data(), detail::simd_nelem(arr0), options);
+}
+
+/// The L2 norm of the difference between two arrays.
+template <typename T>
+T diff_norm2(SimpleArray<T> const & arr0, SimpleArray<T> const & arr1, ReduceOptions const & options = {})
+{
+    detail::reduce_check_pair("diff_norm2", arr0, arr1);
+    return std::sqrt(detail::reduce_norm<T, true, true>(arr0.data(), arr1.data(), detail::simd_nelem(arr0), options));
+}
+
+} /* end namespace reduce */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,135 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Detect the x86 instruction set at run time and hold the level for the
+ * kernels in SimdKernel.hpp and the conversion kernels in StridedCopy.hpp.
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MODMESH_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define MODMESH_SIMD_X86 0
+#endif
+
+namespace modmesh
+{
+
+enum class SimdLevel : int
+{
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2, // With FMA.
+    AVX512 = 3 // F and DQ.
+}; /* end enum class SimdLevel */
+
+/**
+ * Detect the instruction set once and hold the level used by the kernels.
+ */
+class SimdDispatch
+{
+
+public:
+
+    static SimdDispatch & me()
+    {
+        static SimdDispatch instance;
+        return instance;
+    }
+
+    SimdDispatch(SimdDispatch const &) = delete;
+    SimdDispatch(SimdDispatch &&) = delete;
+    SimdDispatch & operator=(SimdDispatch const &) = delete;
+    SimdDispatch & operator=(SimdDispatch &&) = delete;
+    ~SimdDispatch() = default;
+
+    /// The highest level the CPU supports.
+    SimdLevel detected() const { return m_detected; }
+    /// The level the kernels use.
+    SimdLevel level() const { return m_level.load(std::memory_order_relaxed); }
+
+    /// Set the level, which cannot go above the detected one.
+    SimdDispatch & set_level(SimdLevel level)
+    {
+        m_level.store(std::min(level, m_detected), std::memory_order_relaxed);
+        return *this;
+    }
+
+    static char const * name(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        default: return "scalar";
+        }
+    }
+
+private:
+
+    SimdDispatch()
+        : m_detected(detect())
+        , m_level(m_detected)
+    {
+    }
+
+    static SimdLevel detect()
+    {
+#if MODMESH_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+        {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::SCALAR;
+    }
+
+    SimdLevel const m_detected;
+    std::atomic<SimdLevel> m_level;
+
+}; /* end class SimdDispatch */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
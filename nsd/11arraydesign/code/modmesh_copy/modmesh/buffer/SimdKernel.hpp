@@ -0,0 +1,908 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Elementwise and reduction kernels for contiguous SimpleArray data, built
+ * for several x86 instruction sets in the same binary.  The instruction set is
+ * picked at run time from what the CPU reports (cpuid), and may be lowered
+ * with SimdDispatch::set_level() to verify against the scalar kernels.
+ *
+ * Tails shorter than a vector are handled with masked loads and stores
+ * (AVX2, AVX-512) or through a small stack buffer (SSE2), so the data needs
+ * neither alignment nor a length of a multiple of the vector width.
+ */
+
+#include <modmesh/buffer/SimdDispatch.hpp>
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace modmesh
+{
+
+namespace detail
+{
+
+enum class SimdOp
+{
+    ADD,
+    SUB,
+    MUL,
+    MIN,
+    MAX
+}; /* end enum class SimdOp */
+
+namespace simd_scalar
+{
+
+template <typename T, SimdOp OP>
+void kernel_binary(T const * a, T const * b, T * out, size_t n)
+{
+    for (size_t it = 0; it < n; ++it)
+    {
+        if constexpr (SimdOp::ADD == OP) { out[it] = a[it] + b[it]; }
+        else if constexpr (SimdOp::SUB == OP) { out[it] = a[it] - b[it]; }
+        else if constexpr (SimdOp::MUL == OP) { out[it] = a[it] * b[it]; }
+        // Like minps and maxps: b is returned when either is NaN.
+        else if constexpr (SimdOp::MIN == OP) { out[it] = a[it] < b[it] ? a[it] : b[it]; }
+        else { out[it] = a[it] > b[it] ? a[it] : b[it]; }
+    }
+}
+
+template <typename T>
+void kernel_fma(T const * a, T const * b, T const * c, T * out, size_t n)
+{
+    for (size_t it = 0; it < n; ++it)
+    {
+        out[it] = a[it] * b[it] + c[it];
+    }
+}
+
+template <typename T>
+void kernel_abs(T const * a, T * out, size_t n)
+{
+    for (size_t it = 0; it < n; ++it)
+    {
+        out[it] = a[it] < T(0) ? -a[it] : a[it];
+    }
+}
+
+template <typename T>
+T kernel_sum(T const * a, size_t n)
+{
+    T ret = 0;
+    for (size_t it = 0; it < n; ++it)
+    {
+        ret += a[it];
+    }
+    return ret;
+}
+
+template <typename T>
+T kernel_amin(T const * a, size_t n)
+{
+    T ret = std::numeric_limits<T>::max();
+    for (size_t it = 0; it < n; ++it)
+    {
+        ret = ret < a[it] ? ret : a[it];
+    }
+    return ret;
+}
+
+template <typename T>
+T kernel_amax(T const * a, size_t n)
+{
+    T ret = std::numeric_limits<T>::lowest();
+    for (size_t it = 0; it < n; ++it)
+    {
+        ret = ret > a[it] ? ret : a[it];
+    }
+    return ret;
+}
+
+} /* end namespace simd_scalar */
+
+#if MODMESH_SIMD_X86
+
+/*
+ * The kernels written once against a vector traits class Vec<T>.  The macro
+ * is expanded in a namespace per instruction set, inside a region compiled
+ * for that instruction set, so that the intrinsics inline into the loops.
+ */
+// clang-format off
+#define MM_SIMD_DEFINE_KERNELS()                                                            \
+template <typename V, SimdOp OP>                                                            \
+typename V::reg apply(typename V::reg a, typename V::reg b)                                 \
+{                                                                                           \
+    if constexpr (SimdOp::ADD == OP) { return V::add(a, b); }                               \
+    else if constexpr (SimdOp::SUB == OP) { return V::sub(a, b); }                          \
+    else if constexpr (SimdOp::MUL == OP) { return V::mul(a, b); }                          \
+    else if constexpr (SimdOp::MIN == OP) { return V::min(a, b); }                          \
+    else { return V::max(a, b); }                                                           \
+}                                                                                           \
+                                                                                            \
+template <typename T, SimdOp OP>                                                            \
+void kernel_binary(T const * a, T const * b, T * out, size_t n)                             \
+{                                                                                           \
+    using V = Vec<T>;                                                                       \
+    size_t it = 0;                                                                          \
+    for (; it + V::width <= n; it += V::width)                                              \
+    {                                                                                       \
+        V::store(out + it, apply<V, OP>(V::load(a + it), V::load(b + it)));                 \
+    }                                                                                       \
+    if (it < n)                                                                             \
+    {                                                                                       \
+        size_t const m = n - it;                                                            \
+        V::store_partial(out + it, m,                                                       \
+            apply<V, OP>(V::load_partial(a + it, m, T(0)), V::load_partial(b + it, m, T(0)))); \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+template <typename T>                                                                       \
+void kernel_fma(T const * a, T const * b, T const * c, T * out, size_t n)                   \
+{                                                                                           \
+    using V = Vec<T>;                                                                       \
+    size_t it = 0;                                                                          \
+    for (; it + V::width <= n; it += V::width)                                              \
+    {                                                                                       \
+        V::store(out + it, V::fma(V::load(a + it), V::load(b + it), V::load(c + it)));      \
+    }                                                                                       \
+    if (it < n)                                                                             \
+    {                                                                                       \
+        size_t const m = n - it;                                                            \
+        V::store_partial(out + it, m, V::fma(V::load_partial(a + it, m, T(0)),              \
+            V::load_partial(b + it, m, T(0)), V::load_partial(c + it, m, T(0))));           \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+template <typename T>                                                                       \
+void kernel_abs(T const * a, T * out, size_t n)                                             \
+{                                                                                           \
+    using V = Vec<T>;                                                                       \
+    size_t it = 0;                                                                          \
+    for (; it + V::width <= n; it += V::width)                                              \
+    {                                                                                       \
+        V::store(out + it, V::abs(V::load(a + it)));                                        \
+    }                                                                                       \
+    if (it < n)                                                                             \
+    {                                                                                       \
+        V::store_partial(out + it, n - it, V::abs(V::load_partial(a + it, n - it, T(0))));  \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+/* Four accumulators hide the latency of the vector add or max. */                          \
+template <typename T, SimdOp OP>                                                            \
+T kernel_reduce(T const * a, size_t n, T init)                                              \
+{                                                                                           \
+    using V = Vec<T>;                                                                       \
+    typename V::reg acc0 = V::set1(init);                                                   \
+    typename V::reg acc1 = acc0;                                                            \
+    typename V::reg acc2 = acc0;                                                            \
+    typename V::reg acc3 = acc0;                                                            \
+    size_t it = 0;                                                                          \
+    for (; it + 4 * V::width <= n; it += 4 * V::width)                                      \
+    {                                                                                       \
+        acc0 = apply<V, OP>(acc0, V::load(a + it));                                         \
+        acc1 = apply<V, OP>(acc1, V::load(a + it + V::width));                              \
+        acc2 = apply<V, OP>(acc2, V::load(a + it + 2 * V::width));                          \
+        acc3 = apply<V, OP>(acc3, V::load(a + it + 3 * V::width));                          \
+    }                                                                                       \
+    for (; it + V::width <= n; it += V::width)                                              \
+    {                                                                                       \
+        acc0 = apply<V, OP>(acc0, V::load(a + it));                                         \
+    }                                                                                       \
+    if (it < n)                                                                             \
+    {                                                                                       \
+        acc1 = apply<V, OP>(acc1, V::load_partial(a + it, n - it, init));                   \
+    }                                                                                       \
+    acc0 = apply<V, OP>(apply<V, OP>(acc0, acc1), apply<V, OP>(acc2, acc3));                \
+    T lanes[V::width];                                                                      \
+    V::store(lanes, acc0);                                                                  \
+    T ret = init;                                                                           \
+    for (size_t il = 0; il < V::width; ++il)                                                \
+    {                                                                                       \
+        if constexpr (SimdOp::ADD == OP) { ret += lanes[il]; }                              \
+        else if constexpr (SimdOp::MIN == OP) { ret = lanes[il] < ret ? lanes[il] : ret; }  \
+        else { ret = lanes[il] > ret ? lanes[il] : ret; }                                   \
+    }                                                                                       \
+    return ret;                                                                             \
+}                                                                                           \
+                                                                                            \
+template <typename T>                                                                       \
+T kernel_sum(T const * a, size_t n) { return kernel_reduce<T, SimdOp::ADD>(a, n, T(0)); }   \
+                                                                                            \
+template <typename T>                                                                       \
+T kernel_amin(T const * a, size_t n)                                                        \
+{                                                                                           \
+    return kernel_reduce<T, SimdOp::MIN>(a, n, std::numeric_limits<T>::max());             \
+}                                                                                           \
+                                                                                            \
+template <typename T>                                                                       \
+T kernel_amax(T const * a, size_t n)                                                        \
+{                                                                                           \
+    return kernel_reduce<T, SimdOp::MAX>(a, n, std::numeric_limits<T>::lowest());          \
+}
+// clang-format on
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace simd_sse2
+{
+
+template <typename T>
+struct Vec
+{
+    static constexpr bool enabled = false;
+}; /* end struct Vec */
+
+/// SSE2 has no masked memory access; the tail goes through a stack buffer.
+template <typename V, typename T>
+typename V::reg load_tail(T const * p, size_t n, T fill)
+{
+    T buf[V::width];
+    std::fill(buf, buf + V::width, fill);
+    std::memcpy(buf, p, n * sizeof(T));
+    return V::load(buf);
+}
+
+template <typename V, typename T>
+void store_tail(T * p, size_t n, typename V::reg v)
+{
+    T buf[V::width];
+    V::store(buf, v);
+    std::memcpy(p, buf, n * sizeof(T));
+}
+
+template <>
+struct Vec<float>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    using reg = __m128;
+    static reg load(float const * p) { return _mm_loadu_ps(p); }
+    static void store(float * p, reg v) { _mm_storeu_ps(p, v); }
+    static reg load_partial(float const * p, size_t n, float fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(float * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(float v) { return _mm_set1_ps(v); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+    static reg abs(reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static reg fma(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+}; /* end struct Vec<float> */
+
+template <>
+struct Vec<double>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 2;
+    using reg = __m128d;
+    static reg load(double const * p) { return _mm_loadu_pd(p); }
+    static void store(double * p, reg v) { _mm_storeu_pd(p, v); }
+    static reg load_partial(double const * p, size_t n, double fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(double * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(double v) { return _mm_set1_pd(v); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+    static reg abs(reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static reg fma(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+}; /* end struct Vec<double> */
+
+/// SSE2 has no signed byte min, max, or abs; they are built from the compare.
+template <>
+struct Vec<int8_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 16;
+    using reg = __m128i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int8_t const * p) { return _mm_loadu_si128(reinterpret_cast<reg const *>(p)); }
+    static void store(int8_t * p, reg v) { _mm_storeu_si128(reinterpret_cast<reg *>(p), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load_partial(int8_t const * p, size_t n, int8_t fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(int8_t * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(int8_t v) { return _mm_set1_epi8(v); }
+    static reg add(reg a, reg b) { return _mm_add_epi8(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi8(a, b); }
+    /// Multiply the even and the odd bytes in 16-bit lanes and keep the low bytes.
+    static reg mul(reg a, reg b)
+    {
+        reg const even = _mm_mullo_epi16(a, b);
+        reg const odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0xff)), _mm_slli_epi16(odd, 8));
+    }
+    static reg min(reg a, reg b)
+    {
+        reg const gt = _mm_cmpgt_epi8(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+    }
+    static reg max(reg a, reg b)
+    {
+        reg const gt = _mm_cmpgt_epi8(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+    }
+    static reg abs(reg a) { return max(a, _mm_sub_epi8(_mm_setzero_si128(), a)); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int8_t> */
+
+template <>
+struct Vec<int16_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m128i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int16_t const * p) { return _mm_loadu_si128(reinterpret_cast<reg const *>(p)); }
+    static void store(int16_t * p, reg v) { _mm_storeu_si128(reinterpret_cast<reg *>(p), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load_partial(int16_t const * p, size_t n, int16_t fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(int16_t * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(int16_t v) { return _mm_set1_epi16(v); }
+    static reg add(reg a, reg b) { return _mm_add_epi16(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi16(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mullo_epi16(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_epi16(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi16(a, b); }
+    static reg abs(reg a) { return _mm_max_epi16(a, _mm_sub_epi16(_mm_setzero_si128(), a)); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int16_t> */
+
+MM_SIMD_DEFINE_KERNELS()
+
+} /* end namespace simd_sse2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace simd_avx2
+{
+
+template <typename T>
+struct Vec
+{
+    static constexpr bool enabled = false;
+}; /* end struct Vec */
+
+inline __m256i mask32(size_t n) { return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+inline __m256i mask64(size_t n) { return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(n)), _mm256_setr_epi64x(0, 1, 2, 3)); }
+
+/// AVX2 has no masked byte or word access; those tails go through a stack buffer.
+template <typename V, typename T>
+typename V::reg load_tail(T const * p, size_t n, T fill)
+{
+    T buf[V::width];
+    std::fill(buf, buf + V::width, fill);
+    std::memcpy(buf, p, n * sizeof(T));
+    return V::load(buf);
+}
+
+template <typename V, typename T>
+void store_tail(T * p, size_t n, typename V::reg v)
+{
+    T buf[V::width];
+    V::store(buf, v);
+    std::memcpy(p, buf, n * sizeof(T));
+}
+
+template <>
+struct Vec<float>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m256;
+    static reg load(float const * p) { return _mm256_loadu_ps(p); }
+    static void store(float * p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg load_partial(float const * p, size_t n, float fill)
+    {
+        __m256i const m = mask32(n);
+        return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(p, m), _mm256_castsi256_ps(m));
+    }
+    static void store_partial(float * p, size_t n, reg v) { _mm256_maskstore_ps(p, mask32(n), v); }
+    static reg set1(float v) { return _mm256_set1_ps(v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    static reg abs(reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+}; /* end struct Vec<float> */
+
+template <>
+struct Vec<double>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    using reg = __m256d;
+    static reg load(double const * p) { return _mm256_loadu_pd(p); }
+    static void store(double * p, reg v) { _mm256_storeu_pd(p, v); }
+    static reg load_partial(double const * p, size_t n, double fill)
+    {
+        __m256i const m = mask64(n);
+        return _mm256_blendv_pd(_mm256_set1_pd(fill), _mm256_maskload_pd(p, m), _mm256_castsi256_pd(m));
+    }
+    static void store_partial(double * p, size_t n, reg v) { _mm256_maskstore_pd(p, mask64(n), v); }
+    static reg set1(double v) { return _mm256_set1_pd(v); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    static reg abs(reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+}; /* end struct Vec<double> */
+
+template <>
+struct Vec<int32_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m256i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int32_t const * p) { return _mm256_loadu_si256(reinterpret_cast<reg const *>(p)); }
+    static void store(int32_t * p, reg v) { _mm256_storeu_si256(reinterpret_cast<reg *>(p), v); }
+    static reg load_partial(int32_t const * p, size_t n, int32_t fill)
+    {
+        __m256i const m = mask32(n);
+        return _mm256_blendv_epi8(_mm256_set1_epi32(fill), _mm256_maskload_epi32(reinterpret_cast<int const *>(p), m), m);
+    }
+    static void store_partial(int32_t * p, size_t n, reg v) { _mm256_maskstore_epi32(reinterpret_cast<int *>(p), mask32(n), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg set1(int32_t v) { return _mm256_set1_epi32(v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    static reg abs(reg a) { return _mm256_abs_epi32(a); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int32_t> */
+
+template <>
+struct Vec<int64_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    using reg = __m256i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int64_t const * p) { return _mm256_loadu_si256(reinterpret_cast<reg const *>(p)); }
+    static void store(int64_t * p, reg v) { _mm256_storeu_si256(reinterpret_cast<reg *>(p), v); }
+    static reg load_partial(int64_t const * p, size_t n, int64_t fill)
+    {
+        __m256i const m = mask64(n);
+        return _mm256_blendv_epi8(_mm256_set1_epi64x(fill), _mm256_maskload_epi64(reinterpret_cast<long long const *>(p), m), m);
+    }
+    static void store_partial(int64_t * p, size_t n, reg v) { _mm256_maskstore_epi64(reinterpret_cast<long long *>(p), mask64(n), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg set1(int64_t v) { return _mm256_set1_epi64x(v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+    /// AVX2 has no 64-bit multiply; build it from the 32-bit halves.
+    static reg mul(reg a, reg b)
+    {
+        reg const lolo = _mm256_mul_epu32(a, b);
+        reg const lohi = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+        reg const hilo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+        return _mm256_add_epi64(lolo, _mm256_slli_epi64(_mm256_add_epi64(lohi, hilo), 32));
+    }
+    static reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static reg abs(reg a)
+    {
+        reg const zero = _mm256_setzero_si256();
+        return _mm256_blendv_epi8(a, _mm256_sub_epi64(zero, a), _mm256_cmpgt_epi64(zero, a));
+    }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int64_t> */
+
+template <>
+struct Vec<int8_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 32;
+    using reg = __m256i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int8_t const * p) { return _mm256_loadu_si256(reinterpret_cast<reg const *>(p)); }
+    static void store(int8_t * p, reg v) { _mm256_storeu_si256(reinterpret_cast<reg *>(p), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load_partial(int8_t const * p, size_t n, int8_t fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(int8_t * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(int8_t v) { return _mm256_set1_epi8(v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi8(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi8(a, b); }
+    /// Multiply the even and the odd bytes in 16-bit lanes and keep the low bytes.
+    static reg mul(reg a, reg b)
+    {
+        reg const even = _mm256_mullo_epi16(a, b);
+        reg const odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0xff)), _mm256_slli_epi16(odd, 8));
+    }
+    static reg min(reg a, reg b) { return _mm256_min_epi8(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi8(a, b); }
+    static reg abs(reg a) { return _mm256_abs_epi8(a); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int8_t> */
+
+template <>
+struct Vec<int16_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 16;
+    using reg = __m256i;
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load(int16_t const * p) { return _mm256_loadu_si256(reinterpret_cast<reg const *>(p)); }
+    static void store(int16_t * p, reg v) { _mm256_storeu_si256(reinterpret_cast<reg *>(p), v); }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    static reg load_partial(int16_t const * p, size_t n, int16_t fill) { return load_tail<Vec>(p, n, fill); }
+    static void store_partial(int16_t * p, size_t n, reg v) { store_tail<Vec>(p, n, v); }
+    static reg set1(int16_t v) { return _mm256_set1_epi16(v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi16(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi16(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mullo_epi16(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi16(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi16(a, b); }
+    static reg abs(reg a) { return _mm256_abs_epi16(a); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int16_t> */
+
+MM_SIMD_DEFINE_KERNELS()
+
+} /* end namespace simd_avx2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx512f,avx512dq"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512dq")
+// GCC 12 warns on the undefined vector used by the unmasked intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace simd_avx512
+{
+
+template <typename T>
+struct Vec
+{
+    static constexpr bool enabled = false;
+}; /* end struct Vec */
+
+inline __mmask16 mask16(size_t n) { return static_cast<__mmask16>((1U << n) - 1); }
+inline __mmask8 mask8(size_t n) { return static_cast<__mmask8>((1U << n) - 1); }
+
+template <>
+struct Vec<float>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 16;
+    using reg = __m512;
+    static reg load(float const * p) { return _mm512_loadu_ps(p); }
+    static void store(float * p, reg v) { _mm512_storeu_ps(p, v); }
+    static reg load_partial(float const * p, size_t n, float fill) { return _mm512_mask_loadu_ps(_mm512_set1_ps(fill), mask16(n), p); }
+    static void store_partial(float * p, size_t n, reg v) { _mm512_mask_storeu_ps(p, mask16(n), v); }
+    static reg set1(float v) { return _mm512_set1_ps(v); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static reg abs(reg a) { return _mm512_abs_ps(a); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+}; /* end struct Vec<float> */
+
+template <>
+struct Vec<double>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m512d;
+    static reg load(double const * p) { return _mm512_loadu_pd(p); }
+    static void store(double * p, reg v) { _mm512_storeu_pd(p, v); }
+    static reg load_partial(double const * p, size_t n, double fill) { return _mm512_mask_loadu_pd(_mm512_set1_pd(fill), mask8(n), p); }
+    static void store_partial(double * p, size_t n, reg v) { _mm512_mask_storeu_pd(p, mask8(n), v); }
+    static reg set1(double v) { return _mm512_set1_pd(v); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+    static reg abs(reg a) { return _mm512_abs_pd(a); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+}; /* end struct Vec<double> */
+
+template <>
+struct Vec<int32_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 16;
+    using reg = __m512i;
+    static reg load(int32_t const * p) { return _mm512_loadu_si512(p); }
+    static void store(int32_t * p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg load_partial(int32_t const * p, size_t n, int32_t fill) { return _mm512_mask_loadu_epi32(_mm512_set1_epi32(fill), mask16(n), p); }
+    static void store_partial(int32_t * p, size_t n, reg v) { _mm512_mask_storeu_epi32(p, mask16(n), v); }
+    static reg set1(int32_t v) { return _mm512_set1_epi32(v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+    static reg abs(reg a) { return _mm512_abs_epi32(a); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int32_t> */
+
+template <>
+struct Vec<int64_t>
+{
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m512i;
+    static reg load(int64_t const * p) { return _mm512_loadu_si512(p); }
+    static void store(int64_t * p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg load_partial(int64_t const * p, size_t n, int64_t fill) { return _mm512_mask_loadu_epi64(_mm512_set1_epi64(fill), mask8(n), p); }
+    static void store_partial(int64_t * p, size_t n, reg v) { _mm512_mask_storeu_epi64(p, mask8(n), v); }
+    static reg set1(int64_t v) { return _mm512_set1_epi64(v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi64(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi64(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi64(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi64(a, b); }
+    static reg abs(reg a) { return _mm512_abs_epi64(a); }
+    static reg fma(reg a, reg b, reg c) { return add(mul(a, b), c); }
+}; /* end struct Vec<int64_t> */
+
+MM_SIMD_DEFINE_KERNELS()
+
+} /* end namespace simd_avx512 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+#undef MM_SIMD_DEFINE_KERNELS
+
+#endif // MODMESH_SIMD_X86
+
+template <typename T>
+struct SimdKernelTable
+{
+    void (*add)(T const *, T const *, T *, size_t);
+    void (*sub)(T const *, T const *, T *, size_t);
+    void (*mul)(T const *, T const *, T *, size_t);
+    void (*min)(T const *, T const *, T *, size_t);
+    void (*max)(T const *, T const *, T *, size_t);
+    void (*fma)(T const *, T const *, T const *, T *, size_t);
+    void (*abs)(T const *, T *, size_t);
+    T (*sum)(T const *, size_t);
+    T (*amin)(T const *, size_t);
+    T (*amax)(T const *, size_t);
+}; /* end struct SimdKernelTable */
+
+#define MM_SIMD_FILL_TABLE(NS)                                    \
+    {                                                             \
+        &NS::kernel_binary<T, SimdOp::ADD>,                       \
+        &NS::kernel_binary<T, SimdOp::SUB>,                       \
+        &NS::kernel_binary<T, SimdOp::MUL>,                       \
+        &NS::kernel_binary<T, SimdOp::MIN>,                       \
+        &NS::kernel_binary<T, SimdOp::MAX>,                       \
+        &NS::kernel_fma<T>,                                       \
+        &NS::kernel_abs<T>,                                       \
+        &NS::kernel_sum<T>,                                       \
+        &NS::kernel_amin<T>,                                      \
+        &NS::kernel_amax<T>,                                      \
+    }
+
+#define MM_SIMD_LEVEL_TABLE(NS, LOWER)                            \
+    []                                                            \
+    {                                                             \
+        if constexpr (NS::Vec<T>::enabled)                        \
+        {                                                         \
+            return SimdKernelTable<T> MM_SIMD_FILL_TABLE(NS);     \
+        }                                                         \
+        else if constexpr (LOWER::Vec<T>::enabled)                \
+        {                                                         \
+            return SimdKernelTable<T> MM_SIMD_FILL_TABLE(LOWER);  \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            return SimdKernelTable<T> MM_SIMD_FILL_TABLE(simd_scalar); \
+        }                                                         \
+    }()
+
+/**
+ * The kernels of type T for each SimdLevel.  A level without a vector
+ * implementation for T uses the one of the level below, or else the scalar
+ * kernels.
+ */
+template <typename T>
+SimdKernelTable<T> const & simd_kernel_table(SimdLevel level)
+{
+    static SimdKernelTable<T> const tables[] = {
+        MM_SIMD_FILL_TABLE(simd_scalar),
+#if MODMESH_SIMD_X86
+        MM_SIMD_LEVEL_TABLE(simd_sse2, simd_sse2),
+        MM_SIMD_LEVEL_TABLE(simd_avx2, simd_sse2),
+        MM_SIMD_LEVEL_TABLE(simd_avx512, simd_avx2),
+#endif
+    };
+    return tables[std::min(static_cast<size_t>(level), sizeof(tables) / sizeof(tables[0]) - 1)];
+}
+
+#undef MM_SIMD_LEVEL_TABLE
+#undef MM_SIMD_FILL_TABLE
+
+template <typename T>
+SimdKernelTable<T> const & simd_kernel_table()
+{
+    return simd_kernel_table<T>(SimdDispatch::me().level());
+}
+
+template <typename T>
+void simd_check_operand(char const * name, SimpleArray<T> const & arr, SimpleArray<T> const & out)
+{
+    if (!arr.is_c_contiguous() || !out.is_c_contiguous())
+    {
+        std::ostringstream ms;
+        ms << "simd::" << name << ": arrays must be C-contiguous";
+        throw std::runtime_error(ms.str());
+    }
+    if (!(arr.shape() == out.shape()))
+    {
+        std::ostringstream ms;
+        ms << "simd::" << name << ": shape mismatch";
+        throw std::runtime_error(ms.str());
+    }
+}
+
+template <typename T>
+size_t simd_nelem(SimpleArray<T> const & arr)
+{
+    size_t ret = 1;
+    for (size_t it = 0; it < arr.ndim(); ++it)
+    {
+        ret *= arr.shape(it);
+    }
+    return ret;
+}
+
+} /* end namespace detail */
+
+/*
+ * Kernels on C-contiguous SimpleArray of the same shape.  The vector code is
+ * there for float, double, int8_t, int16_t, int32_t and int64_t; other types
+ * use the scalar kernels.  The AVX-512 level (F and DQ) has no byte or word
+ * instructions, so it runs the AVX2 kernels for int8_t and int16_t.
+ * Floating-point results may differ from the scalar kernels in the last bits,
+ * because the sum is accumulated in a different order and fma is fused with
+ * AVX2 and AVX-512.  min and max follow the instruction set for NaN: the
+ * second operand is returned, and the scalar kernels do the same.
+ */
+namespace simd
+{
+
+#define MM_DECL_SIMD_BINARY(NAME)                                                             \
+    template <typename T>                                                                     \
+    void NAME(SimpleArray<T> const & a, SimpleArray<T> const & b, SimpleArray<T> & out)       \
+    {                                                                                         \
+        detail::simd_check_operand(#NAME, a, out);                                            \
+        detail::simd_check_operand(#NAME, b, out);                                            \
+        detail::simd_kernel_table<T>().NAME(a.data(), b.data(), out.data(), detail::simd_nelem(out)); \
+    }
+
+MM_DECL_SIMD_BINARY(add)
+MM_DECL_SIMD_BINARY(sub)
+MM_DECL_SIMD_BINARY(mul)
+MM_DECL_SIMD_BINARY(min)
+MM_DECL_SIMD_BINARY(max)
+
+#undef MM_DECL_SIMD_BINARY
+
+/// out = a * b + c
+template <typename T>
+void fma(SimpleArray<T> const & a, SimpleArray<T> const & b, SimpleArray<T> const & c, SimpleArray<T> & out)
+{
+    detail::simd_check_operand("fma", a, out);
+    detail::simd_check_operand("fma", b, out);
+    detail::simd_check_operand("fma", c, out);
+    detail::simd_kernel_table<T>().fma(a.data(), b.data(), c.data(), out.data(), detail::simd_nelem(out));
+}
+
+template <typename T>
+void abs(SimpleArray<T> const & a, SimpleArray<T> & out)
+{
+    detail::simd_check_operand("abs", a, out);
+    detail::simd_kernel_table<T>().abs(a.data(), out.data(), detail::simd_nelem(out));
+}
+
+template <typename T>
+T sum(SimpleArray<T> const & a)
+{
+    detail::simd_check_operand("sum", a, a);
+    return detail::simd_kernel_table<T>().sum(a.data(), detail::simd_nelem(a));
+}
+
+/// The minimum element; like numpy.amin it is an error for an empty array.
+template <typename T>
+T amin(SimpleArray<T> const & a)
+{
+    detail::simd_check_operand("amin", a, a);
+    size_t const nelem = detail::simd_nelem(a);
+    if (0 == nelem)
+    {
+        throw std::runtime_error("simd::amin: empty array");
+    }
+    return detail::simd_kernel_table<T>().amin(a.data(), nelem);
+}
+
+/// The maximum element; like numpy.amax it is an error for an empty array.
+template <typename T>
+T amax(SimpleArray<T> const & a)
+{
+    detail::simd_check_operand("amax", a, a);
+    size_t const nelem = detail::simd_nelem(a);
+    if (0 == nelem)
+    {
+        throw std::runtime_error("simd::amax: empty array");
+    }
+    return detail::simd_kernel_table<T>().amax(a.data(), nelem);
+}
+
+} /* end namespace simd */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -29,8 +29,13 @@
  */
 
 #include <modmesh/buffer/ConcreteBuffer.hpp>
+#include <modmesh/buffer/Broadcast.hpp>
+#include <modmesh/buffer/StridedCopy.hpp>
 
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #if defined(_MSC_VER)
 #include <BaseTsd.h>
@@ -63,7 +68,8 @@ size_t buffer_offset(S const & strides, Args... args)
     return detail::buffer_offset_impl<0>(strides, args...);
 }
 
-inline size_t buffer_offset(small_vector<size_t> const & stride, small_vector<size_t> const & idx)
+template <size_t N, size_t M>
+size_t buffer_offset(small_vector<size_t, N> const & stride, small_vector<size_t, M> const & idx)
 {
     if (stride.size() != idx.size())
     {
@@ -81,10 +87,80 @@ inline size_t buffer_offset(small_vector<size_t> const & stride, small_vector<si
     return offset;
 }
 
+/**
+ * Memory order of a newly allocated SimpleArray: the row-major (C) order has
+ * the last index running fastest, and the column-major (Fortran) order the
+ * first, as LAPACK and BLAS expect.
+ */
+enum class ArrayLayout
+{
+    C,
+    F
+}; /* end enum class ArrayLayout */
+
+/**
+ * Indices start, start + step, ..., up to but not including stop, in a
+ * dimension of SimpleArray.  The step must be positive.
+ */
+struct SimpleSlice
+{
+    size_t start = 0;
+    size_t stop = 0;
+    size_t step = 1;
+
+    size_t length() const { return start >= stop ? 0 : (stop - start + step - 1) / step; }
+}; /* end struct SimpleSlice */
+
+/**
+ * Number of dimensions of SimpleArray<T> whose shape and stride are kept
+ * without heap allocation.  Specialize it for an element type to change it.
+ */
+template <typename T>
+struct SimpleArrayInlineNdim : std::integral_constant<size_t, 6>
+{
+}; /* end struct SimpleArrayInlineNdim */
+
+template <typename T>
+class SimpleArray;
+
+template <typename T, size_t ND, size_t INNER>
+class FixedArray;
+
+template <typename E>
+class ArrayExpression;
+
+template <typename T, typename E>
+void assign_expression(SimpleArray<T> & dst, ArrayExpression<E> const & expr);
+
+/**
+ * Record shared by the copy-on-write arrays of a buffer.  The use count of
+ * the shared pointer holding it is the number of the arrays.
+ */
+struct SimpleArrayCowShare
+{
+    /// A mutable alias writes to the buffer, so that no copy may share it.
+    bool aliased = false;
+}; /* end struct SimpleArrayCowShare */
+
 /**
  * Simple array type for contiguous memory storage. Size does not change. The
  * copy semantics performs data copy. The move semantics invalidates the
  * existing memory buffer.
+ *
+ * With copy-on-write turned on (set_copy_on_write()), a copy shares the
+ * buffer with the source and the data copy is deferred until either of them
+ * is accessed mutably: by any non-const accessor or make_mutable().  Only
+ * the copies and the const aliases are counted as sharers, so writing to an
+ * array does not detach it from its own mutable views.  The check before a
+ * write is a null test of the flag when copy-on-write is off.
+ *
+ * The copy-on-write flag goes with the value: copy and move, by construction
+ * or by assignment, take the flag of the source.  The aliases (reshape(),
+ * view(), broadcast_to()) of a const array are copy-on-write when it is, so
+ * that they do not write to the sharers.  Those of a mutable array, and its
+ * buffer(), detach it first and write to it.  They are not tracked, so the
+ * array is marked as aliased: later copies take the data right away instead
+ * of sharing the buffer with the aliases, and later aliases write to it too.
  */
 template <typename T>
 class SimpleArray
@@ -93,16 +169,18 @@ class SimpleArray
 public:
 
     using value_type = T;
-    using shape_type = small_vector<size_t>;
-    using sshape_type = small_vector<ssize_t>;
+    static constexpr size_t INLINE_NDIM = SimpleArrayInlineNdim<T>::value;
+    using shape_type = small_vector<size_t, INLINE_NDIM>;
+    using sshape_type = small_vector<ssize_t, INLINE_NDIM>;
     using buffer_type = ConcreteBuffer;
+    using alignment_type = typename buffer_type::alignment_type;
 
     static constexpr size_t ITEMSIZE = sizeof(value_type);
 
     static constexpr size_t itemsize() { return ITEMSIZE; }
 
-    explicit SimpleArray(size_t length)
-        : m_buffer(buffer_type::construct(length * ITEMSIZE))
+    explicit SimpleArray(size_t length, alignment_type alignment = alignment_type::DEFAULT)
+        : m_buffer(buffer_type::construct(length * ITEMSIZE, alignment))
         , m_shape{length}
         , m_stride{1}
         , m_body(m_buffer->data<T>())
@@ -116,38 +194,82 @@ public:
         std::copy(first, last, data());
     }
 
+    explicit SimpleArray(shape_type const & shape, alignment_type alignment = alignment_type::DEFAULT)
+        : SimpleArray(shape, ArrayLayout::C, alignment)
+    {
+    }
+
     // NOLINTNEXTLINE(modernize-pass-by-value)
-    explicit SimpleArray(small_vector<size_t> const & shape)
+    explicit SimpleArray(shape_type const & shape, ArrayLayout layout, alignment_type alignment = alignment_type::DEFAULT)
         : m_shape(shape)
-        , m_stride(calc_stride(m_shape))
+        , m_stride(calc_stride(m_shape, layout))
     {
         if (!m_shape.empty())
         {
-            m_buffer = buffer_type::construct(m_shape[0] * m_stride[0] * ITEMSIZE);
+            m_buffer = buffer_type::construct(calc_span(m_shape, m_stride) * ITEMSIZE, alignment);
             m_body = m_buffer->data<T>();
         }
     }
 
     // NOLINTNEXTLINE(modernize-pass-by-value)
-    explicit SimpleArray(small_vector<size_t> const & shape, value_type const & value)
-        : SimpleArray(shape)
+    explicit SimpleArray(shape_type const & shape, value_type const & value, alignment_type alignment = alignment_type::DEFAULT)
+        : SimpleArray(shape, alignment)
     {
         std::fill(begin(), end(), value);
     }
 
-    explicit SimpleArray(std::vector<size_t> const & shape)
+    /**
+     * Allocate with ConcreteBuffer::construct_numa(), whose pages are first
+     * touched by numa.nthread threads over the element ranges
+     * [size * i / nthread, size * (i + 1) / nthread).  A threaded kernel
+     * partitioning the array the same way then reads the memory of its own
+     * NUMA node.  The elements are zero.
+     */
+    // NOLINTNEXTLINE(modernize-pass-by-value)
+    explicit SimpleArray(shape_type const & shape, BufferNumaOptions const & numa)
         : m_shape(shape)
         , m_stride(calc_stride(m_shape))
     {
         if (!m_shape.empty())
         {
-            m_buffer = buffer_type::construct(m_shape[0] * m_stride[0] * ITEMSIZE);
+            m_buffer = buffer_type::construct_numa(calc_span(m_shape, m_stride) * ITEMSIZE, numa);
             m_body = m_buffer->data<T>();
         }
     }
 
-    explicit SimpleArray(std::vector<size_t> const & shape, value_type const & value)
-        : SimpleArray(shape)
+    /**
+     * Allocate like SimpleArray(shape, numa) and fill with value by the same
+     * threads over the same element ranges.
+     */
+    // NOLINTNEXTLINE(modernize-pass-by-value)
+    explicit SimpleArray(shape_type const & shape, value_type const & value, BufferNumaOptions const & numa)
+        : SimpleArray(shape, numa)
+    {
+        static value_type const zero{};
+        if (std::is_trivially_copyable_v<value_type> && 0 == std::memcmp(&value, &zero, ITEMSIZE))
+        {
+            return; // The fresh pages are already zero.
+        }
+        size_t const total = size();
+        value_type * const data = m_body;
+        detail::numa_parallel(
+            numa.nthread,
+            [&](size_t ithread, size_t nthread)
+            { std::fill(data + total * ithread / nthread, data + total * (ithread + 1) / nthread, value); });
+    }
+
+    explicit SimpleArray(std::vector<size_t> const & shape, alignment_type alignment = alignment_type::DEFAULT)
+        : SimpleArray(shape_type(shape), ArrayLayout::C, alignment)
+    {
+    }
+
+    explicit SimpleArray(std::vector<size_t> const & shape, ArrayLayout layout, alignment_type alignment = alignment_type::DEFAULT)
+        : SimpleArray(shape_type(shape), layout, alignment)
+    {
+    }
+
+    explicit SimpleArray(std::vector<size_t> const & shape, value_type const & value, alignment_type alignment = alignment_type::DEFAULT)
+        : SimpleArray(shape, alignment)
     {
         std::fill(begin(), end(), value);
     }
@@ -172,7 +294,7 @@ public:
         }
     }
 
-    explicit SimpleArray(small_vector<size_t> const & shape, std::shared_ptr<buffer_type> const & buffer)
+    explicit SimpleArray(shape_type const & shape, std::shared_ptr<buffer_type> const & buffer)
         : SimpleArray(buffer)
     {
         if (buffer)
@@ -189,6 +311,31 @@ public:
         }
     }
 
+    /**
+     * View a buffer with arbitrary non-negative element strides, e.g., a
+     * Fortran-ordered or sliced NumPy array.  The buffer starts at the first
+     * element and must cover the last one.
+     */
+    explicit SimpleArray(shape_type const & shape, shape_type const & stride, std::shared_ptr<buffer_type> const & buffer)
+        : SimpleArray(buffer)
+    {
+        if (shape.size() != stride.size())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: shape dimension " << shape.size() << " differs from stride dimension " << stride.size();
+            throw std::runtime_error(ms.str());
+        }
+        m_shape = shape;
+        m_stride = stride;
+        const size_t nbytes = calc_span(m_shape, m_stride) * ITEMSIZE;
+        if (nbytes > buffer->nbytes())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: strided shape spans " << nbytes << " bytes beyond buffer " << buffer->nbytes();
+            throw std::runtime_error(ms.str());
+        }
+    }
+
     SimpleArray(std::initializer_list<T> init)
         : SimpleArray(init.size())
     {
@@ -201,11 +348,12 @@ public:
     }
 
     SimpleArray(SimpleArray const & other)
-        : m_buffer(other.m_buffer->clone())
+        : m_buffer(other.is_shareable() ? other.m_buffer : other.m_buffer->clone())
         , m_shape(other.m_shape)
         , m_stride(other.m_stride)
         , m_nghost(other.m_nghost)
         , m_body(calc_body(m_buffer->data<T>(), m_stride, other.m_nghost))
+        , m_cow(other.share_for_copy())
     {
     }
 
@@ -215,6 +363,7 @@ public:
         , m_stride(std::move(other.m_stride))
         , m_nghost(other.m_nghost)
         , m_body(other.m_body)
+        , m_cow(std::move(other.m_cow))
     {
     }
 
@@ -222,11 +371,28 @@ public:
     {
         if (this != &other)
         {
-            *m_buffer = *(other.m_buffer); // Size is checked inside.
+            if (other.is_shareable())
+            {
+                if (nbytes() != other.nbytes())
+                {
+                    throw std::out_of_range("Buffer size mismatch");
+                }
+                m_buffer = other.m_buffer;
+            }
+            else
+            {
+                if (is_shared())
+                {
+                    // The data is overwritten right away; no need to copy.
+                    detach(/* copy */ false);
+                }
+                *m_buffer = *(other.m_buffer); // Size is checked inside.
+            }
             m_shape = other.m_shape;
             m_stride = other.m_stride;
             m_nghost = other.m_nghost;
             m_body = calc_body(m_buffer->data<T>(), m_stride, other.m_nghost);
+            m_cow = other.share_for_copy();
         }
         return *this;
     }
@@ -240,10 +406,28 @@ public:
             m_stride = std::move(other.m_stride);
             m_nghost = other.m_nghost;
             m_body = other.m_body;
+            m_cow = std::move(other.m_cow);
         }
         return *this;
     }
 
+    /// Evaluate an array expression (ArrayExpression.hpp) into a new array.
+    template <typename E>
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    SimpleArray(ArrayExpression<E> const & expr)
+        : SimpleArray(expr.derived().shape())
+    {
+        assign_expression(*this, expr);
+    }
+
+    /// Evaluate an array expression (ArrayExpression.hpp) in one fused pass.
+    template <typename E>
+    SimpleArray & operator=(ArrayExpression<E> const & expr)
+    {
+        assign_expression(*this, expr);
+        return *this;
+    }
+
     ~SimpleArray() = default;
 
     template <typename... Args>
@@ -253,20 +437,47 @@ public:
         return *this;
     }
 
-    static shape_type calc_stride(shape_type const & shape)
+    static shape_type calc_stride(shape_type const & shape, ArrayLayout layout = ArrayLayout::C)
     {
         shape_type stride(shape.size());
         if (!shape.empty())
         {
-            stride[shape.size() - 1] = 1;
-            for (size_t it = shape.size() - 1; it > 0; --it)
+            if (ArrayLayout::F == layout)
             {
-                stride[it - 1] = stride[it] * shape[it];
+                stride[0] = 1;
+                for (size_t it = 1; it < shape.size(); ++it)
+                {
+                    stride[it] = stride[it - 1] * shape[it - 1];
+                }
+            }
+            else
+            {
+                stride[shape.size() - 1] = 1;
+                for (size_t it = shape.size() - 1; it > 0; --it)
+                {
+                    stride[it - 1] = stride[it] * shape[it];
+                }
             }
         }
         return stride;
     }
 
+    /// Number of elements from the first to the last one addressed by the
+    /// shape and stride, inclusively.
+    static size_t calc_span(shape_type const & shape, shape_type const & stride)
+    {
+        size_t span = 1;
+        for (size_t it = 0; it < shape.size(); ++it)
+        {
+            if (0 == shape[it])
+            {
+                return 0;
+            }
+            span += (shape[it] - 1) * stride[it];
+        }
+        return span;
+    }
+
     static T * calc_body(T * data, shape_type const & stride, size_t nghost)
     {
         if (nullptr == data || stride.empty() || 0 == nghost)
@@ -285,17 +496,56 @@ public:
     explicit operator bool() const noexcept { return bool(m_buffer) && bool(*m_buffer); }
 
     size_t nbytes() const noexcept { return m_buffer ? m_buffer->nbytes() : 0; }
-    size_t size() const noexcept { return nbytes() / ITEMSIZE; }
+
+    /**
+     * Number of elements, the product of the shape.  It is not taken from
+     * the buffer, which a strided view does not fill and a broadcast view
+     * does not cover.
+     */
+    size_t size() const noexcept
+    {
+        if (m_shape.empty())
+        {
+            return 0;
+        }
+        size_t ret = 1;
+        for (size_t const v : m_shape)
+        {
+            ret *= v;
+        }
+        return ret;
+    }
 
     using iterator = T *;
     using const_iterator = T const *;
 
-    iterator begin() noexcept { return data(); }
-    iterator end() noexcept { return data() + size(); }
-    const_iterator begin() const noexcept { return data(); }
-    const_iterator end() const noexcept { return data() + size(); }
-    const_iterator cbegin() const noexcept { return begin(); }
-    const_iterator cend() const noexcept { return end(); }
+    /*
+     * The iterators walk the memory flat, which holds every element once
+     * only for a contiguous array.  They throw for a strided or broadcast
+     * array; use to_layout() to copy it first.
+     */
+    iterator begin()
+    {
+        validate_contiguous();
+        return data();
+    }
+    iterator end()
+    {
+        validate_contiguous();
+        return data() + size();
+    }
+    const_iterator begin() const
+    {
+        validate_contiguous();
+        return data();
+    }
+    const_iterator end() const
+    {
+        validate_contiguous();
+        return data() + size();
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
 
     value_type const & operator[](size_t it) const noexcept { return data(it); }
     value_type & operator[](size_t it) noexcept { return data(it); }
@@ -329,15 +579,13 @@ public:
 
     value_type const & at(shape_type const & idx) const
     {
-        const size_t offset = buffer_offset(m_stride, idx);
-        validate_range(offset);
-        return data(offset);
+        validate_index(idx);
+        return data(buffer_offset(m_stride, idx));
     }
     value_type & at(shape_type const & idx)
     {
-        const size_t offset = buffer_offset(m_stride, idx);
-        validate_range(offset);
-        return data(offset);
+        validate_index(idx);
+        return data(buffer_offset(m_stride, idx));
     }
 
     value_type const & at(std::vector<ssize_t> const & idx) const { return at(sshape_type(idx)); }
@@ -368,6 +616,65 @@ public:
     size_t stride(size_t it) const noexcept { return m_stride[it]; }
     size_t & stride(size_t it) noexcept { return m_stride[it]; }
 
+    /**
+     * Test for the row-major (C) layout without gaps.  The stride of a
+     * dimension of length 1 does not matter.  The flat accessor operator[]
+     * follows the element order only when the array is C-contiguous, and
+     * begin() and end() refuse an array that is not contiguous.
+     */
+    bool is_c_contiguous() const
+    {
+        size_t expected = 1;
+        for (size_t it = m_shape.size(); it > 0; --it)
+        {
+            if (1 != m_shape[it - 1] && expected != m_stride[it - 1])
+            {
+                return false;
+            }
+            expected *= m_shape[it - 1];
+        }
+        return true;
+    }
+
+    /// Test for the column-major (Fortran) layout without gaps.
+    bool is_f_contiguous() const
+    {
+        size_t expected = 1;
+        for (size_t it = 0; it < m_shape.size(); ++it)
+        {
+            if (1 != m_shape[it] && expected != m_stride[it])
+            {
+                return false;
+            }
+            expected *= m_shape[it];
+        }
+        return true;
+    }
+
+    bool is_contiguous() const { return is_c_contiguous() || is_f_contiguous(); }
+
+    /**
+     * Copy into a new array of the same shape and nghost in the given memory
+     * order, e.g., a Fortran-ordered matrix for LAPACK from any input.
+     */
+    SimpleArray to_layout(ArrayLayout layout) const
+    {
+        SimpleArray ret(m_shape, layout, alignment());
+        if (ret)
+        {
+            sshape_type dst_stride(m_shape.size());
+            sshape_type src_stride(m_shape.size());
+            for (size_t it = 0; it < m_shape.size(); ++it)
+            {
+                dst_stride[it] = static_cast<ssize_t>(ret.m_stride[it]);
+                src_stride[it] = static_cast<ssize_t>(m_stride[it]);
+            }
+            strided_copy(ret.data(), dst_stride, data(), src_stride, m_shape);
+        }
+        ret.set_nghost(m_nghost);
+        return ret;
+    }
+
     size_t nghost() const { return m_nghost; }
     size_t nbody() const { return m_shape.empty() ? 0 : m_shape[0] - m_nghost; }
     bool has_ghost() const { return m_nghost != 0; }
@@ -398,17 +705,169 @@ public:
     template <typename U>
     SimpleArray<U> reshape(shape_type const & shape) const
     {
-        return SimpleArray<U>(shape, m_buffer);
+        SimpleArray<U> ret(typename SimpleArray<U>::shape_type(shape), m_buffer);
+        ret.m_cow = share_for_alias();
+        return ret;
+    }
+    template <typename U>
+    SimpleArray<U> reshape(shape_type const & shape)
+    {
+        make_aliased();
+        SimpleArray<U> ret(typename SimpleArray<U>::shape_type(shape), m_buffer);
+        return ret;
     }
 
-    SimpleArray reshape(shape_type const & shape) const
+    SimpleArray reshape(shape_type const & shape) const { return alias(SimpleArray(shape, m_buffer)); }
+    SimpleArray reshape(shape_type const & shape)
     {
+        make_aliased();
         return SimpleArray(shape, m_buffer);
     }
 
-    SimpleArray reshape() const
+    SimpleArray reshape() const { return reshape(m_shape); }
+    SimpleArray reshape() { return reshape(m_shape); }
+
+    /**
+     * Return a view of the sub-block selected by the slices, one for each of
+     * the leading dimensions.  The remaining dimensions are taken whole.  The
+     * slices index the whole dimensions including the ghost cells, and the
+     * view has no ghost.  The view shares the memory of this array and nothing
+     * is copied.
+     */
+    SimpleArray view(std::vector<SimpleSlice> const & slices) const
     {
-        return SimpleArray(m_shape, m_buffer);
+        if (slices.size() > ndim())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: " << slices.size() << " slices for " << ndim() << "-dimensional array";
+            throw std::out_of_range(ms.str());
+        }
+        if (!m_buffer)
+        {
+            throw std::out_of_range("SimpleArray: cannot view an array without buffer");
+        }
+        shape_type shape(m_shape);
+        shape_type stride(m_stride);
+        size_t offset = 0;
+        for (size_t it = 0; it < slices.size(); ++it)
+        {
+            SimpleSlice const & slice = slices[it];
+            if (0 == slice.step)
+            {
+                throw std::out_of_range("SimpleArray: slice step cannot be zero");
+            }
+            size_t const length = slice.length();
+            if (0 != length && (slice.start >= m_shape[it] || slice.stop > m_shape[it]))
+            {
+                std::ostringstream ms;
+                ms << "SimpleArray: slice [" << slice.start << ":" << slice.stop << ":" << slice.step
+                   << "] out of bounds of dim " << it << " with shape " << m_shape[it];
+                throw std::out_of_range(ms.str());
+            }
+            shape[it] = length;
+            stride[it] = m_stride[it] * slice.step;
+            offset += 0 == length ? 0 : slice.start * m_stride[it];
+        }
+        size_t const span = calc_span(shape, stride);
+        return alias(SimpleArray(shape, stride, m_buffer->view(offset * ITEMSIZE, span * ITEMSIZE)));
+    }
+    SimpleArray view(std::vector<SimpleSlice> const & slices)
+    {
+        make_aliased();
+        return plain(std::as_const(*this).view(slices));
+    }
+
+    /// Return a view of the sub-block selected in a dimension.
+    SimpleArray view(size_t dim, size_t start, size_t stop, size_t step = 1) const
+    {
+        if (dim >= ndim())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: dim " << dim << " >= ndim " << ndim();
+            throw std::out_of_range(ms.str());
+        }
+        std::vector<SimpleSlice> slices(dim + 1);
+        for (size_t it = 0; it < dim; ++it)
+        {
+            slices[it] = SimpleSlice{0, m_shape[it], 1};
+        }
+        slices[dim] = SimpleSlice{start, stop, step};
+        return view(slices);
+    }
+    SimpleArray view(size_t dim, size_t start, size_t stop, size_t step = 1)
+    {
+        make_aliased();
+        return plain(std::as_const(*this).view(dim, start, stop, step));
+    }
+
+    /**
+     * Return a view reading the array as if it had the shape, like
+     * numpy.broadcast_to.  The stretched dimensions have the stride 0, so
+     * the view takes no memory of its own, and its elements along them are
+     * the same memory; do not write through it.  The shape includes the
+     * ghost cells, and the view has no ghost.
+     */
+    SimpleArray broadcast_to(shape_type const & shape) const
+    {
+        if (!m_buffer)
+        {
+            throw std::out_of_range("SimpleArray: cannot broadcast an array without buffer");
+        }
+        shape_type const stride = modmesh::broadcast_stride(m_shape, m_stride, shape);
+        size_t const span = calc_span(shape, stride);
+        return alias(SimpleArray(shape, stride, m_buffer->view(0, span * ITEMSIZE)));
+    }
+    SimpleArray broadcast_to(shape_type const & shape)
+    {
+        make_aliased();
+        return plain(std::as_const(*this).broadcast_to(shape));
+    }
+
+    /**
+     * Return a view without the dimensions marked in drop, which must have
+     * the length 1, like indexing them with an integer in NumPy.  Dropping
+     * all dimensions leaves a 1-element array.  The view has no ghost.
+     */
+    SimpleArray squeeze(std::vector<bool> const & drop) const
+    {
+        if (drop.size() != ndim())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: " << drop.size() << " dimensions to drop for " << ndim() << "-dimensional array";
+            throw std::out_of_range(ms.str());
+        }
+        if (!m_buffer)
+        {
+            throw std::out_of_range("SimpleArray: cannot squeeze an array without buffer");
+        }
+        shape_type shape;
+        shape_type stride;
+        for (size_t it = 0; it < ndim(); ++it)
+        {
+            if (!drop[it])
+            {
+                shape.push_back(m_shape[it]);
+                stride.push_back(m_stride[it]);
+            }
+            else if (1 != m_shape[it])
+            {
+                std::ostringstream ms;
+                ms << "SimpleArray: cannot drop dim " << it << " with shape " << m_shape[it];
+                throw std::out_of_range(ms.str());
+            }
+        }
+        if (shape.empty())
+        {
+            shape.push_back(1);
+            stride.push_back(1);
+        }
+        size_t const span = calc_span(shape, stride);
+        return alias(SimpleArray(shape, stride, m_buffer->view(0, span * ITEMSIZE)));
+    }
+    SimpleArray squeeze(std::vector<bool> const & drop)
+    {
+        make_aliased();
+        return plain(std::as_const(*this).squeeze(drop));
     }
 
     void swap(SimpleArray & other) noexcept
@@ -420,6 +879,7 @@ public:
             std::swap(m_stride, other.m_stride);
             std::swap(m_nghost, other.m_nghost);
             std::swap(m_body, other.m_body);
+            std::swap(m_cow, other.m_cow);
         }
     }
 
@@ -431,22 +891,136 @@ public:
     template <typename... Args>
     value_type const * vptr(Args... args) const { return m_body + buffer_offset(m_stride, args...); }
     template <typename... Args>
-    value_type * vptr(Args... args) { return m_body + buffer_offset(m_stride, args...); }
+    value_type * vptr(Args... args)
+    {
+        make_mutable();
+        return m_body + buffer_offset(m_stride, args...);
+    }
 
     /* Backdoor */
     value_type const & data(size_t it) const { return data()[it]; }
     value_type & data(size_t it) { return data()[it]; }
     value_type const * data() const { return buffer().template data<value_type>(); }
-    value_type * data() { return buffer().template data<value_type>(); }
+    value_type * data()
+    {
+        make_mutable();
+        return m_buffer->template data<value_type>();
+    }
 
     buffer_type const & buffer() const { return *m_buffer; }
-    buffer_type & buffer() { return *m_buffer; }
+    /// The buffer may be held and written to; see make_aliased().
+    buffer_type & buffer()
+    {
+        make_aliased();
+        return *m_buffer;
+    }
+
+    alignment_type alignment() const noexcept { return m_buffer ? m_buffer->alignment() : alignment_type::DEFAULT; }
 
     value_type const * body() const { return m_body; }
-    value_type * body() { return m_body; }
+    value_type * body()
+    {
+        make_mutable();
+        return m_body;
+    }
+
+    bool copy_on_write() const noexcept { return bool(m_cow); }
+    /// Turning copy-on-write off detaches a shared array first, so that it
+    /// does not write to the sharers.
+    SimpleArray & set_copy_on_write(bool enabled)
+    {
+        if (!enabled)
+        {
+            make_mutable();
+            m_cow.reset();
+        }
+        else if (!m_cow)
+        {
+            m_cow = std::make_shared<SimpleArrayCowShare>();
+        }
+        return *this;
+    }
+
+    /// Test whether copy-on-write is on and another copy or const alias
+    /// shares the buffer.
+    bool is_shared() const noexcept { return m_cow && m_cow.use_count() > 1; }
+
+    /// Take a private copy of the buffer if it is shared by copy-on-write.
+    /// Every non-const accessor calls it.
+    SimpleArray & make_mutable()
+    {
+        if (is_shared())
+        {
+            detach(/* copy */ true);
+        }
+        return *this;
+    }
+
+    /**
+     * Make the array mutable for an alias that writes to it and is not
+     * tracked: a mutable view, reshape() or broadcast_to(), or the buffer().
+     * A copy-on-write array is marked as aliased, so that it is copied
+     * right away instead of shared with the alias.
+     */
+    SimpleArray & make_aliased()
+    {
+        make_mutable();
+        if (m_cow)
+        {
+            m_cow->aliased = true;
+        }
+        return *this;
+    }
 
 private:
 
+    template <typename U>
+    friend class SimpleArray;
+
+    template <typename U, size_t ND, size_t INNER>
+    friend class FixedArray;
+
+    using share_type = std::shared_ptr<SimpleArrayCowShare>;
+
+    /// Test whether a copy may share the buffer instead of copying it.
+    bool is_shareable() const noexcept { return m_cow && !m_cow->aliased; }
+
+    /// Return the copy-on-write record for a copy of this array.
+    share_type share_for_copy() const
+    {
+        if (!m_cow)
+        {
+            return nullptr;
+        }
+        return m_cow->aliased ? std::make_shared<SimpleArrayCowShare>() : m_cow;
+    }
+
+    /// Return the copy-on-write record for a const alias of this array.  The
+    /// alias of an aliased array writes to it like the others do.
+    share_type share_for_alias() const { return is_shareable() ? m_cow : nullptr; }
+
+    /// Give a const alias of this array its copy-on-write record.
+    SimpleArray alias(SimpleArray && ret) const
+    {
+        ret.m_cow = share_for_alias();
+        return std::move(ret);
+    }
+
+    /// Make an alias taken after make_aliased() a plain array writing to this one.
+    static SimpleArray plain(SimpleArray && ret)
+    {
+        ret.m_cow.reset();
+        return std::move(ret);
+    }
+
+    void detach(bool copy)
+    {
+        T const * const old_data = m_buffer->data<T>();
+        m_buffer = copy ? m_buffer->clone() : buffer_type::construct(m_buffer->nbytes(), m_buffer->alignment());
+        m_body = m_buffer->data<T>() + (m_body - old_data);
+        m_cow = std::make_shared<SimpleArrayCowShare>();
+    }
+
     void validate_range(ssize_t it) const
     {
         if (m_nghost != 0 && ndim() != 1)
@@ -462,16 +1036,42 @@ private:
             ms << "SimpleArray: index " << it << " < -nghost: " << -static_cast<ssize_t>(m_nghost);
             throw std::out_of_range(ms.str());
         }
-        if (it >= static_cast<ssize_t>(size() - m_nghost))
+        // The flat index addresses the memory, which a broadcast array has
+        // fewer elements of than its size().
+        size_t const nflat = nbytes() / ITEMSIZE;
+        if (it >= static_cast<ssize_t>(nflat - m_nghost))
         {
             std::ostringstream ms;
-            ms << "SimpleArray: index " << it << " >= " << size() - m_nghost
-               << " (size: " << size() << " - nghost: " << m_nghost << ")";
+            ms << "SimpleArray: index " << it << " >= " << nflat - m_nghost
+               << " (size: " << nflat << " - nghost: " << m_nghost << ")";
             throw std::out_of_range(ms.str());
         }
     }
 
-    void validate_shape(small_vector<ssize_t> const & idx) const
+    void validate_contiguous() const
+    {
+        if (0 != size() && !is_contiguous())
+        {
+            throw std::out_of_range("SimpleArray: cannot iterate flat over a non-contiguous array");
+        }
+    }
+
+    /// Check the index counted from the first ghost, like at(shape_type).
+    void validate_index(shape_type const & idx) const
+    {
+        sshape_type sidx(idx.size());
+        for (size_t it = 0; it < idx.size(); ++it)
+        {
+            sidx[it] = static_cast<ssize_t>(idx[it]);
+        }
+        if (!sidx.empty())
+        {
+            sidx[0] -= static_cast<ssize_t>(m_nghost);
+        }
+        validate_shape(sidx);
+    }
+
+    void validate_shape(sshape_type const & idx) const
     {
         auto index2string = [&idx]()
         {
@@ -548,6 +1148,9 @@ private:
 
     size_t m_nghost = 0;
     value_type * m_body = nullptr;
+    /// Copy-on-write record shared with the copies and const aliases; null
+    /// when copy-on-write is off.
+    share_type m_cow;
 
 }; /* end class SimpleArray */
 
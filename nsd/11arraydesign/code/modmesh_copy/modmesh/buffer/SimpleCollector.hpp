@@ -0,0 +1,386 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Growable append buffer for building a SimpleArray of unknown length.
+ *
+ * The elements are appended to a ConcreteBuffer whose capacity grows
+ * geometrically, so that push_back() and extend() are amortized O(1).  Past
+ * MREMAP_BYTES on Linux the storage moves to an anonymous mapping grown by
+ * mremap(), which remaps the pages instead of copying them.  When the
+ * construction is done, as_array() hands the storage to a SimpleArray
+ * without copying.
+ */
+
+#include <modmesh/buffer/SimpleArray.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace modmesh
+{
+
+template <typename T>
+class SimpleCollector
+{
+
+    static_assert(std::is_trivially_copyable_v<T>, "SimpleCollector needs a trivially copyable element type");
+
+public:
+
+    using value_type = T;
+    using buffer_type = ConcreteBuffer;
+    using array_type = SimpleArray<T>;
+    using iterator = T *;
+    using const_iterator = T const *;
+
+    static constexpr size_t ITEMSIZE = sizeof(value_type);
+    /// Capacity of the first allocation in elements.
+    static constexpr size_t MIN_CAPACITY = 16;
+    /// Capacity in bytes from which the storage is a mapping grown by mremap().
+    static constexpr size_t MREMAP_BYTES = size_t(1) << 22; // 4 MB
+
+    SimpleCollector() = default;
+
+    explicit SimpleCollector(size_t capacity) { reserve(capacity); }
+
+    SimpleCollector(SimpleCollector const &) = delete;
+    SimpleCollector & operator=(SimpleCollector const &) = delete;
+
+    SimpleCollector(SimpleCollector && other) noexcept
+        : m_buffer(std::move(other.m_buffer))
+        , m_map_base(std::exchange(other.m_map_base, nullptr))
+        , m_map_length(std::exchange(other.m_map_length, 0))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    SimpleCollector & operator=(SimpleCollector && other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_buffer = std::move(other.m_buffer);
+            m_map_base = std::exchange(other.m_map_base, nullptr);
+            m_map_length = std::exchange(other.m_map_length, 0);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+        }
+        return *this;
+    }
+
+    ~SimpleCollector() { release(); }
+
+    size_t size() const noexcept { return m_size; }
+    size_t capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return 0 == m_size; }
+    size_t nbytes() const noexcept { return m_size * ITEMSIZE; }
+    /// Whether the storage is an anonymous mapping grown by mremap().
+    bool mapped() const noexcept { return nullptr != m_map_base; }
+
+    value_type const * data() const noexcept { return m_data; }
+    value_type * data() noexcept { return m_data; }
+
+    iterator begin() noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    value_type const & operator[](size_t it) const noexcept { return m_data[it]; }
+    value_type & operator[](size_t it) noexcept { return m_data[it]; }
+
+    value_type const & at(size_t it) const
+    {
+        validate_range(it);
+        return m_data[it];
+    }
+    value_type & at(size_t it)
+    {
+        validate_range(it);
+        return m_data[it];
+    }
+
+    value_type const & back() const noexcept { return m_data[m_size - 1]; }
+    value_type & back() noexcept { return m_data[m_size - 1]; }
+
+    /// Make room for at least capacity elements without changing the size.
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            reallocate(capacity);
+        }
+    }
+
+    void push_back(value_type const & value)
+    {
+        if (m_size == m_capacity)
+        {
+            // The value may be an element of this collector.
+            value_type const copy = value;
+            grow(m_size + 1);
+            m_data[m_size] = copy;
+        }
+        else
+        {
+            m_data[m_size] = value;
+        }
+        ++m_size;
+    }
+
+    template <class... Args>
+    value_type & emplace_back(Args &&... args)
+    {
+        // The arguments may refer to an element of this collector, so
+        // construct before growing.
+        value_type const value(std::forward<Args>(args)...);
+        if (m_size == m_capacity)
+        {
+            grow(m_size + 1);
+        }
+        m_data[m_size] = value;
+        return m_data[m_size++];
+    }
+
+    /// Append the elements of [first, last).
+    template <class InputIt>
+    void extend(InputIt first, InputIt last)
+    {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+        {
+            auto const count = static_cast<size_t>(std::distance(first, last));
+            if (m_size + count > m_capacity)
+            {
+                if constexpr (std::is_pointer_v<InputIt> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, value_type>)
+                {
+                    // The range may be in this collector, which growing frees.
+                    std::less<value_type const *> const less;
+                    if (0 != count && !less(first, m_data) && less(first, m_data + m_size))
+                    {
+                        size_t const offset = static_cast<size_t>(first - m_data);
+                        grow(m_size + count);
+                        std::copy_n(m_data + offset, count, m_data + m_size);
+                        m_size += count;
+                        return;
+                    }
+                }
+                grow(m_size + count);
+            }
+            std::copy(first, last, m_data + m_size);
+            m_size += count;
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+        }
+    }
+
+    /// Append the elements of arr in C order, including the ghost elements.
+    void extend(array_type const & arr)
+    {
+        if (arr.is_c_contiguous())
+        {
+            extend(arr.data(), arr.data() + arr.size());
+        }
+        else
+        {
+            array_type const carr = arr.to_layout(ArrayLayout::C);
+            extend(carr.data(), carr.data() + carr.size());
+        }
+    }
+
+    /// Drop the elements and keep the capacity.
+    void clear() noexcept { m_size = 0; }
+
+    /**
+     * Hand the elements to a 1D SimpleArray without copying, and leave the
+     * collector empty.  The array keeps the storage; the unused capacity is
+     * returned to the system when the storage is a mapping.
+     */
+    array_type as_array()
+    {
+        std::shared_ptr<buffer_type> buffer;
+        if (mapped())
+        {
+#if !defined(_WIN32)
+            // Give back the whole pages beyond the elements; the mapping stays in place.
+            auto const pagesize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            size_t const length = std::max((nbytes() + pagesize - 1) / pagesize * pagesize, pagesize);
+            if (length < m_map_length)
+            {
+                ::munmap(static_cast<int8_t *>(m_map_base) + length, m_map_length - length);
+                m_map_length = length;
+            }
+            buffer = buffer_type::construct(
+                nbytes(),
+                m_map_base,
+                std::make_unique<detail::ConcreteBufferMmapRemover>(m_map_base, m_map_length));
+#endif // _WIN32
+            m_map_base = nullptr;
+            m_map_length = 0;
+        }
+        else if (m_buffer && nbytes() == m_buffer->nbytes())
+        {
+            buffer = std::move(m_buffer);
+        }
+        else if (m_buffer)
+        {
+            buffer = m_buffer->view(0, nbytes());
+        }
+        else
+        {
+            buffer = buffer_type::construct(0);
+        }
+        m_buffer.reset();
+        m_data = nullptr;
+        m_capacity = 0;
+        return array_type(typename array_type::shape_type{std::exchange(m_size, 0)}, buffer);
+    }
+
+private:
+
+    void validate_range(size_t it) const
+    {
+        if (it >= m_size)
+        {
+            std::ostringstream ms;
+            ms << "SimpleCollector: index " << it << " is out of bounds with size " << m_size;
+            throw std::out_of_range(ms.str());
+        }
+    }
+
+    /// Double the capacity, or more to hold needed elements.
+    void grow(size_t needed)
+    {
+        reallocate(std::max({needed, m_capacity * 2, MIN_CAPACITY}));
+    }
+
+    void reallocate(size_t capacity)
+    {
+        size_t const nbytes_new = capacity * ITEMSIZE;
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        if (nbytes_new >= MREMAP_BYTES)
+        {
+            remap(nbytes_new);
+            m_capacity = capacity;
+            return;
+        }
+#endif // __linux__ && MREMAP_MAYMOVE
+        std::shared_ptr<buffer_type> buffer = buffer_type::construct(nbytes_new);
+        if (0 != m_size)
+        {
+            std::memcpy(buffer->data(), m_data, nbytes());
+        }
+        m_buffer = std::move(buffer);
+        m_data = m_buffer->template data<value_type>();
+        m_capacity = capacity;
+    }
+
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    void remap(size_t nbytes_new)
+    {
+        auto const pagesize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t const length = (nbytes_new + pagesize - 1) / pagesize * pagesize;
+        void * base = nullptr;
+        if (mapped())
+        {
+            // The kernel moves the page table entries; the elements are not copied.
+            base = ::mremap(m_map_base, m_map_length, length, MREMAP_MAYMOVE);
+        }
+        else
+        {
+            // NOLINTNEXTLINE(hicpp-signed-bitwise)
+            base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (MAP_FAILED != base && 0 != m_size)
+            {
+                std::memcpy(base, m_data, nbytes());
+            }
+        }
+        if (MAP_FAILED == base)
+        {
+            throw std::bad_alloc();
+        }
+        m_buffer.reset();
+        m_map_base = base;
+        m_map_length = length;
+        m_data = static_cast<value_type *>(base);
+    }
+#endif // __linux__ && MREMAP_MAYMOVE
+
+    void release() noexcept
+    {
+#if !defined(_WIN32)
+        if (mapped())
+        {
+            ::munmap(m_map_base, m_map_length);
+        }
+#endif // _WIN32
+        m_buffer.reset();
+        m_map_base = nullptr;
+        m_map_length = 0;
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+    /// The storage below MREMAP_BYTES.
+    std::shared_ptr<buffer_type> m_buffer;
+    /// The mapping at and above MREMAP_BYTES.
+    void * m_map_base = nullptr;
+    size_t m_map_length = 0;
+    value_type * m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+
+}; /* end class SimpleCollector */
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
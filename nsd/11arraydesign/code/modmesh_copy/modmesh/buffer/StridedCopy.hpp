@@ -0,0 +1,298 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <modmesh/buffer/small_vector.hpp>
+#include <modmesh/buffer/NdIter.hpp>
+#include <modmesh/buffer/SimdDispatch.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace modmesh
+{
+
+namespace detail
+{
+
+namespace simd_convert_scalar
+{
+
+template <typename D, typename S>
+inline void convert(D * dst, S const * src, size_t length)
+{
+    for (size_t it = 0; it < length; ++it)
+    {
+        // NOLINTNEXTLINE(bugprone-signed-char-misuse, cert-str34-c)
+        dst[it] = static_cast<D>(src[it]);
+    }
+}
+
+} /* end namespace simd_convert_scalar */
+
+#if MODMESH_SIMD_X86
+
+// The vector conversions round like static_cast (to nearest under the default
+// MXCSR), and the remainder shorter than a vector goes to the scalar loop.
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace simd_convert_sse2
+{
+
+inline void convert(double * dst, int32_t const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 2 <= length; it += 2)
+    {
+        _mm_storeu_pd(dst + it, _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(src + it))));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(double * dst, float const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 2 <= length; it += 2)
+    {
+        __m128 const v = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double const *>(src + it)));
+        _mm_storeu_pd(dst + it, _mm_cvtps_pd(v));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(float * dst, double const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 4 <= length; it += 4)
+    {
+        __m128 const lo = _mm_cvtpd_ps(_mm_loadu_pd(src + it));
+        __m128 const hi = _mm_cvtpd_ps(_mm_loadu_pd(src + it + 2));
+        _mm_storeu_ps(dst + it, _mm_movelh_ps(lo, hi));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+} /* end namespace simd_convert_sse2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace simd_convert_avx2
+{
+
+inline void convert(double * dst, int32_t const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        __m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + it));
+        _mm256_storeu_pd(dst + it, _mm256_cvtepi32_pd(_mm256_castsi256_si128(v)));
+        _mm256_storeu_pd(dst + it + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(double * dst, float const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        __m256 const v = _mm256_loadu_ps(src + it);
+        _mm256_storeu_pd(dst + it, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        _mm256_storeu_pd(dst + it + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(float * dst, double const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        __m128 const lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + it));
+        __m128 const hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + it + 4));
+        _mm256_storeu_ps(dst + it, _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+} /* end namespace simd_convert_avx2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// _mm512_undefined_pd() in the conversion intrinsics trips these.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace simd_convert_avx512
+{
+
+inline void convert(double * dst, int32_t const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        _mm512_storeu_pd(dst + it, _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + it))));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(double * dst, float const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        _mm512_storeu_pd(dst + it, _mm512_cvtps_pd(_mm256_loadu_ps(src + it)));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+inline void convert(float * dst, double const * src, size_t length)
+{
+    size_t it = 0;
+    for (; it + 8 <= length; it += 8)
+    {
+        _mm256_storeu_ps(dst + it, _mm512_cvtpd_ps(_mm512_loadu_pd(src + it)));
+    }
+    simd_convert_scalar::convert(dst + it, src + it, length - it);
+}
+
+} /* end namespace simd_convert_avx512 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+#endif // MODMESH_SIMD_X86
+
+/// The type pairs with explicit vector conversion kernels.
+template <typename D, typename S>
+inline constexpr bool is_simd_convertible_v =
+    (std::is_same_v<D, double> && (std::is_same_v<S, int32_t> || std::is_same_v<S, float>)) ||
+    (std::is_same_v<D, float> && std::is_same_v<S, double>);
+
+/**
+ * Convert a contiguous run of elements, with the vector kernel of the level
+ * SimdDispatch holds for the pairs that have one.
+ */
+template <typename D, typename S>
+void convert_contiguous(D * dst, S const * src, size_t length)
+{
+#if MODMESH_SIMD_X86
+    if constexpr (is_simd_convertible_v<D, S>)
+    {
+        switch (SimdDispatch::me().level())
+        {
+        case SimdLevel::AVX512: simd_convert_avx512::convert(dst, src, length); return;
+        case SimdLevel::AVX2: simd_convert_avx2::convert(dst, src, length); return;
+        case SimdLevel::SSE2: simd_convert_sse2::convert(dst, src, length); return;
+        default: break;
+        }
+    }
+#endif
+    simd_convert_scalar::convert(dst, src, length);
+}
+
+template <typename D, typename S>
+void strided_copy_inner(D * dst, ssize_t dst_stride, S const * src, ssize_t src_stride, size_t length)
+{
+    if (1 == dst_stride && 1 == src_stride)
+    {
+        if constexpr (std::is_same_v<D, S>)
+        {
+            std::memcpy(dst, src, length * sizeof(D));
+        }
+        else
+        {
+            convert_contiguous(dst, src, length);
+        }
+    }
+    else
+    {
+        for (size_t it = 0; it < length; ++it)
+        {
+            // NOLINTNEXTLINE(bugprone-signed-char-misuse, cert-str34-c)
+            *dst = static_cast<D>(*src);
+            dst += dst_stride;
+            src += src_stride;
+        }
+    }
+}
+
+} /* end namespace detail */
+
+/**
+ * Copy an N-dimensional strided block of S elements into a block of D
+ * elements without recursion.  The strides are counted in elements and may be
+ * negative, or 0 to broadcast the source.  NdIter drops the dimensions of length 1 and collapses the
+ * dimensions contiguous in both blocks, so that a contiguous copy becomes a
+ * single memcpy (for the same type) or a single conversion loop.  The
+ * int32 to double, float to double, and double to float conversions use
+ * SSE2, AVX2, or AVX-512 kernels picked by SimdDispatch.
+ */
+template <typename D, typename S>
+void strided_copy(
+    D * dst,
+    typename NdIter<D, S const>::sshape_type const & dst_stride,
+    S const * src,
+    typename NdIter<D, S const>::sshape_type const & src_stride,
+    typename NdIter<D, S const>::shape_type const & shape)
+{
+    NdIter<D, S const> iter(shape, {dst_stride, src_stride}, dst, src);
+    iter.for_each(
+        [](size_t length, auto const & stride, D * dst_inner, S const * src_inner)
+        { detail::strided_copy_inner(dst_inner, stride[0], src_inner, stride[1], length); });
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -0,0 +1,578 @@
+#pragma once
+
+/*
+ * Copyright (c) 2022, Yung-Yu Chen <yyc@solvcon.net>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the copyright holder nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Transposition and axis permutation of SimpleArray.
+ *
+ * The copy is cut into square tiles small enough for a source and a
+ * destination tile to stay in L1 cache together, so that neither the strided
+ * reads nor the strided writes walk through a new page or cache line per
+ * element.  Inside a tile, 4- and 8-byte elements are moved in 4x4 or 8x8
+ * blocks transposed in SIMD registers.  The tiles are distributed over
+ * threads.
+ */
+
+#include <modmesh/buffer/SimdKernel.hpp>
+#include <modmesh/buffer/StridedCopy.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace modmesh
+{
+
+/**
+ * Options of transpose(), permute() and transpose_inplace().
+ */
+struct TransposeOptions
+{
+    /// Number of threads; 0 uses std::thread::hardware_concurrency().
+    size_t nthread = 0;
+}; /* end struct TransposeOptions */
+
+namespace detail
+{
+
+/// Number of elements on a side of a tile.
+inline constexpr size_t TRANSPOSE_TILE = 32;
+/// Do not start a thread for less than this number of elements.
+inline constexpr size_t TRANSPOSE_GRAIN = 1 << 16;
+
+template <typename T>
+inline constexpr bool transpose_vectorizable = std::is_trivially_copyable_v<T> && (4 == sizeof(T) || 8 == sizeof(T));
+
+/**
+ * Transpose a block: dst[j*dld + i] = src[i*sld + j] for i < nrow and
+ * j < ncol.  The leading dimensions are counted in elements.
+ */
+template <typename T>
+void transpose_block_scalar(T const * src, ssize_t sld, T * dst, ssize_t dld, size_t nrow, size_t ncol)
+{
+    for (size_t i = 0; i < nrow; ++i)
+    {
+        T const * srow = src + static_cast<ssize_t>(i) * sld;
+        for (size_t j = 0; j < ncol; ++j)
+        {
+            dst[static_cast<ssize_t>(j) * dld + static_cast<ssize_t>(i)] = srow[j];
+        }
+    }
+}
+
+/**
+ * Transpose the strips of a block left over by square SIMD blocks of W
+ * elements on a side.
+ */
+template <size_t W, typename T>
+void transpose_block_edge(T const * src, ssize_t sld, T * dst, ssize_t dld, size_t nrow, size_t ncol)
+{
+    size_t const nrow_v = nrow - nrow % W;
+    size_t const ncol_v = ncol - ncol % W;
+    transpose_block_scalar(src + ncol_v, sld, dst + static_cast<ssize_t>(ncol_v) * dld, dld, nrow, ncol - ncol_v);
+    transpose_block_scalar(src + static_cast<ssize_t>(nrow_v) * sld, sld, dst + nrow_v, dld, nrow - nrow_v, ncol_v);
+}
+
+#if MODMESH_SIMD_X86
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace simd_sse2
+{
+
+inline void transpose_square(float const * src, ssize_t sld, float * dst, ssize_t dld)
+{
+    __m128 r0 = _mm_loadu_ps(src);
+    __m128 r1 = _mm_loadu_ps(src + sld);
+    __m128 r2 = _mm_loadu_ps(src + 2 * sld);
+    __m128 r3 = _mm_loadu_ps(src + 3 * sld);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + dld, r1);
+    _mm_storeu_ps(dst + 2 * dld, r2);
+    _mm_storeu_ps(dst + 3 * dld, r3);
+}
+
+inline void transpose_square(double const * src, ssize_t sld, double * dst, ssize_t dld)
+{
+    __m128d const r0 = _mm_loadu_pd(src);
+    __m128d const r1 = _mm_loadu_pd(src + sld);
+    _mm_storeu_pd(dst, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd(dst + dld, _mm_unpackhi_pd(r0, r1));
+}
+
+template <typename T>
+void transpose_block(T const * src, ssize_t sld, T * dst, ssize_t dld, size_t nrow, size_t ncol)
+{
+    // The shuffles only move bits, so any 4- or 8-byte type goes as float or double.
+    using lane_type = std::conditional_t<4 == sizeof(T), float, double>;
+    constexpr size_t W = 16 / sizeof(T);
+    auto const * s = reinterpret_cast<lane_type const *>(src);
+    auto * d = reinterpret_cast<lane_type *>(dst);
+    for (size_t i = 0; i + W <= nrow; i += W)
+    {
+        for (size_t j = 0; j + W <= ncol; j += W)
+        {
+            transpose_square(
+                s + static_cast<ssize_t>(i) * sld + static_cast<ssize_t>(j), sld,
+                d + static_cast<ssize_t>(j) * dld + static_cast<ssize_t>(i), dld);
+        }
+    }
+    transpose_block_edge<W>(src, sld, dst, dld, nrow, ncol);
+}
+
+} /* end namespace simd_sse2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace simd_avx2
+{
+
+inline void transpose_square(float const * src, ssize_t sld, float * dst, ssize_t dld)
+{
+    __m256 const r0 = _mm256_loadu_ps(src);
+    __m256 const r1 = _mm256_loadu_ps(src + sld);
+    __m256 const r2 = _mm256_loadu_ps(src + 2 * sld);
+    __m256 const r3 = _mm256_loadu_ps(src + 3 * sld);
+    __m256 const r4 = _mm256_loadu_ps(src + 4 * sld);
+    __m256 const r5 = _mm256_loadu_ps(src + 5 * sld);
+    __m256 const r6 = _mm256_loadu_ps(src + 6 * sld);
+    __m256 const r7 = _mm256_loadu_ps(src + 7 * sld);
+    // Interleave pairs of rows, then pairs of pairs within each 128-bit lane.
+    __m256 const t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 const t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 const t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 const t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 const t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 const t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 const t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 const t7 = _mm256_unpackhi_ps(r6, r7);
+    __m256 const s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 const s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 const s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 const s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 const s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 const s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 const s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 const s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    // Swap the 128-bit lanes across the upper and the lower four rows.
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + dld, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dld, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dld, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dld, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dld, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dld, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dld, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+inline void transpose_square(double const * src, ssize_t sld, double * dst, ssize_t dld)
+{
+    __m256d const r0 = _mm256_loadu_pd(src);
+    __m256d const r1 = _mm256_loadu_pd(src + sld);
+    __m256d const r2 = _mm256_loadu_pd(src + 2 * sld);
+    __m256d const r3 = _mm256_loadu_pd(src + 3 * sld);
+    __m256d const t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d const t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d const t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d const t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst + dld, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst + 2 * dld, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst + 3 * dld, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+template <typename T>
+void transpose_block(T const * src, ssize_t sld, T * dst, ssize_t dld, size_t nrow, size_t ncol)
+{
+    using lane_type = std::conditional_t<4 == sizeof(T), float, double>;
+    constexpr size_t W = 32 / sizeof(T);
+    auto const * s = reinterpret_cast<lane_type const *>(src);
+    auto * d = reinterpret_cast<lane_type *>(dst);
+    for (size_t i = 0; i + W <= nrow; i += W)
+    {
+        for (size_t j = 0; j + W <= ncol; j += W)
+        {
+            transpose_square(
+                s + static_cast<ssize_t>(i) * sld + static_cast<ssize_t>(j), sld,
+                d + static_cast<ssize_t>(j) * dld + static_cast<ssize_t>(i), dld);
+        }
+    }
+    transpose_block_edge<W>(src, sld, dst, dld, nrow, ncol);
+}
+
+} /* end namespace simd_avx2 */
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // MODMESH_SIMD_X86
+
+template <typename T>
+using transpose_block_type = void (*)(T const *, ssize_t, T *, ssize_t, size_t, size_t);
+
+/**
+ * The block kernel of type T for the SimdLevel.  AVX-512 uses the AVX2
+ * kernel; a tile is too small for 16x16 blocks of float to pay off.
+ */
+template <typename T>
+transpose_block_type<T> transpose_block_kernel(SimdLevel level)
+{
+#if MODMESH_SIMD_X86
+    if constexpr (transpose_vectorizable<T>)
+    {
+        if (level >= SimdLevel::AVX2)
+        {
+            return &simd_avx2::transpose_block<T>;
+        }
+        if (level >= SimdLevel::SSE2)
+        {
+            return &simd_sse2::transpose_block<T>;
+        }
+    }
+#else
+    (void)level;
+#endif
+    return &transpose_block_scalar<T>;
+}
+
+/**
+ * Run work(begin, end) over ntask tasks, each thread taking a contiguous
+ * range of them.
+ */
+template <typename W>
+void transpose_parallel(size_t ntask, size_t nelem, TransposeOptions const & options, W && work)
+{
+    size_t nthread = options.nthread;
+    if (0 == nthread)
+    {
+        nthread = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nthread = std::max(std::min({nthread, ntask, (nelem + TRANSPOSE_GRAIN - 1) / TRANSPOSE_GRAIN}), size_t(1));
+
+    auto run = [&](size_t ithread)
+    { work(ntask * ithread / nthread, ntask * (ithread + 1) / nthread); };
+    std::vector<std::thread> threads;
+    threads.reserve(nthread - 1);
+    for (size_t it = 1; it < nthread; ++it)
+    {
+        threads.emplace_back(run, it);
+    }
+    run(0);
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Tiled copy of a batch of 2-D planes.  In every plane, the element at row i
+ * and column j is read from src[i*sld + j] and written to dst[j*dld + i].  The
+ * planes are spread by the outer shape and strides.
+ */
+template <typename T>
+void transpose_planes(
+    T const * src,
+    small_vector<ssize_t> const & src_outer_stride,
+    ssize_t sld,
+    T * dst,
+    small_vector<ssize_t> const & dst_outer_stride,
+    ssize_t dld,
+    small_vector<size_t> const & outer_shape,
+    size_t nrow,
+    size_t ncol,
+    TransposeOptions const & options)
+{
+    size_t nouter = 1;
+    for (size_t it = 0; it < outer_shape.size(); ++it)
+    {
+        nouter *= outer_shape[it];
+    }
+    size_t const ntrow = (nrow + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    size_t const ntcol = (ncol + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    size_t const ntask = nouter * ntrow * ntcol;
+    if (0 == ntask)
+    {
+        return;
+    }
+    transpose_block_type<T> const kernel = transpose_block_kernel<T>(SimdDispatch::me().level());
+
+    auto work = [&](size_t begin, size_t end)
+    {
+        for (size_t itask = begin; itask < end; ++itask)
+        {
+            size_t const tcol = itask % ntcol;
+            size_t const trow = (itask / ntcol) % ntrow;
+            size_t iouter = itask / (ntcol * ntrow);
+            ssize_t soff = 0;
+            ssize_t doff = 0;
+            for (size_t it = outer_shape.size(); it > 0; --it)
+            {
+                size_t const idx = iouter % outer_shape[it - 1];
+                iouter /= outer_shape[it - 1];
+                soff += static_cast<ssize_t>(idx) * src_outer_stride[it - 1];
+                doff += static_cast<ssize_t>(idx) * dst_outer_stride[it - 1];
+            }
+            size_t const i0 = trow * TRANSPOSE_TILE;
+            size_t const j0 = tcol * TRANSPOSE_TILE;
+            kernel(
+                src + soff + static_cast<ssize_t>(i0) * sld + static_cast<ssize_t>(j0), sld,
+                dst + doff + static_cast<ssize_t>(j0) * dld + static_cast<ssize_t>(i0), dld,
+                std::min(TRANSPOSE_TILE, nrow - i0),
+                std::min(TRANSPOSE_TILE, ncol - j0));
+        }
+    };
+    transpose_parallel(ntask, nouter * nrow * ncol, options, work);
+}
+
+template <typename T>
+void permute_check(SimpleArray<T> const & arr, small_vector<size_t> const & axes)
+{
+    if (axes.size() != arr.ndim())
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: " << axes.size() << " axes to permute a " << arr.ndim() << "-dimensional array";
+        throw std::out_of_range(ms.str());
+    }
+    std::vector<bool> seen(axes.size(), false);
+    for (size_t it = 0; it < axes.size(); ++it)
+    {
+        if (axes[it] >= axes.size())
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: axis " << axes[it] << " out of range for " << arr.ndim() << "-dimensional array";
+            throw std::out_of_range(ms.str());
+        }
+        if (seen[axes[it]])
+        {
+            std::ostringstream ms;
+            ms << "SimpleArray: axis " << axes[it] << " repeats in the permutation";
+            throw std::out_of_range(ms.str());
+        }
+        seen[axes[it]] = true;
+    }
+}
+
+} /* end namespace detail */
+
+/**
+ * Return a C-contiguous copy of arr with the axes reordered: axis it of the
+ * result is axis axes[it] of arr.  nghost is kept when axis 0 stays in place.
+ *
+ * When the fastest axis changes, the copy goes tile by tile over the plane of
+ * the old and the new fastest axes.  Otherwise the copy already runs over
+ * contiguous rows and is done by strided_copy.
+ */
+template <typename T>
+SimpleArray<T> permute(SimpleArray<T> const & arr, small_vector<size_t> const & axes, TransposeOptions const & options = {})
+{
+    detail::permute_check(arr, axes);
+    size_t const ndim = arr.ndim();
+
+    small_vector<size_t> shape(ndim);
+    for (size_t it = 0; it < ndim; ++it)
+    {
+        shape[it] = arr.shape(axes[it]);
+    }
+    SimpleArray<T> ret(shape, arr.alignment());
+    if (0 != ndim && 0 == axes[0])
+    {
+        ret.set_nghost(arr.nghost());
+    }
+    if (!ret || 0 == detail::simd_nelem(ret))
+    {
+        return ret;
+    }
+
+    // Strides of both arrays in the order of the axes of the result.
+    small_vector<ssize_t> src_stride(ndim);
+    small_vector<ssize_t> dst_stride(ndim);
+    for (size_t it = 0; it < ndim; ++it)
+    {
+        src_stride[it] = static_cast<ssize_t>(arr.stride(axes[it]));
+        dst_stride[it] = static_cast<ssize_t>(ret.stride(it));
+    }
+
+    // Find the axis (in the order of the result) that is contiguous in arr.
+    size_t unit = ndim;
+    for (size_t it = 0; it < ndim; ++it)
+    {
+        if (1 == src_stride[it] && shape[it] > 1)
+        {
+            unit = it;
+        }
+    }
+    if (ndim < 2 || ndim == unit || ndim - 1 == unit)
+    {
+        strided_copy(ret.data(), dst_stride, arr.data(), src_stride, shape);
+        return ret;
+    }
+
+    // Rows of a plane run along the fastest axis of the result, and columns
+    // along the fastest axis of arr.
+    small_vector<ssize_t> src_outer_stride;
+    small_vector<ssize_t> dst_outer_stride;
+    small_vector<size_t> outer_shape;
+    for (size_t it = 0; it < ndim - 1; ++it)
+    {
+        if (it != unit)
+        {
+            src_outer_stride.push_back(src_stride[it]);
+            dst_outer_stride.push_back(dst_stride[it]);
+            outer_shape.push_back(shape[it]);
+        }
+    }
+    detail::transpose_planes(
+        arr.data(),
+        src_outer_stride,
+        src_stride[ndim - 1],
+        ret.data(),
+        dst_outer_stride,
+        dst_stride[unit],
+        outer_shape,
+        shape[ndim - 1],
+        shape[unit],
+        options);
+    return ret;
+}
+
+/**
+ * Return a C-contiguous copy of arr with the order of the axes reversed, like
+ * numpy.transpose().
+ */
+template <typename T>
+SimpleArray<T> transpose(SimpleArray<T> const & arr, TransposeOptions const & options = {})
+{
+    small_vector<size_t> axes(arr.ndim());
+    for (size_t it = 0; it < axes.size(); ++it)
+    {
+        axes[it] = axes.size() - 1 - it;
+    }
+    return permute(arr, axes, options);
+}
+
+/**
+ * Transpose a square 2-D array in place.  One of the strides must be 1.  Pairs
+ * of tiles mirrored by the diagonal are swapped through a scratch tile.  The
+ * ghost rows do not survive the transposition, so nghost is reset to 0.
+ */
+template <typename T>
+void transpose_inplace(SimpleArray<T> & arr, TransposeOptions const & options = {})
+{
+    if (2 != arr.ndim() || arr.shape(0) != arr.shape(1))
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: transpose_inplace needs a square 2-dimensional array";
+        throw std::runtime_error(ms.str());
+    }
+    ssize_t ld = 0;
+    if (1 == arr.stride(1) || 1 >= arr.shape(0))
+    {
+        ld = static_cast<ssize_t>(arr.stride(0));
+    }
+    else if (1 == arr.stride(0))
+    {
+        ld = static_cast<ssize_t>(arr.stride(1));
+    }
+    else
+    {
+        std::ostringstream ms;
+        ms << "SimpleArray: transpose_inplace needs a unit stride";
+        throw std::runtime_error(ms.str());
+    }
+    arr.set_nghost(0);
+    size_t const n = arr.shape(0);
+    if (n < 2)
+    {
+        return;
+    }
+
+    T * data = arr.data();
+    constexpr size_t TILE = detail::TRANSPOSE_TILE;
+    size_t const ntile = (n + TILE - 1) / TILE;
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(ntile * (ntile + 1) / 2);
+    for (size_t bi = 0; bi < ntile; ++bi)
+    {
+        for (size_t bj = bi; bj < ntile; ++bj)
+        {
+            pairs.emplace_back(bi, bj);
+        }
+    }
+    detail::transpose_block_type<T> const kernel = detail::transpose_block_kernel<T>(SimdDispatch::me().level());
+
+    auto work = [&](size_t begin, size_t end)
+    {
+        std::vector<T> scratch(TILE * TILE);
+        constexpr ssize_t sld = static_cast<ssize_t>(TILE);
+        for (size_t ipair = begin; ipair < end; ++ipair)
+        {
+            size_t const i0 = pairs[ipair].first * TILE;
+            size_t const j0 = pairs[ipair].second * TILE;
+            size_t const ni = std::min(TILE, n - i0);
+            size_t const nj = std::min(TILE, n - j0);
+            T * upper = data + static_cast<ssize_t>(i0) * ld + static_cast<ssize_t>(j0);
+            T * lower = data + static_cast<ssize_t>(j0) * ld + static_cast<ssize_t>(i0);
+            // The scratch tile takes the transposed upper tile (nj by ni).
+            kernel(upper, ld, scratch.data(), sld, ni, nj);
+            if (i0 != j0)
+            {
+                kernel(lower, ld, upper, ld, nj, ni);
+            }
+            for (size_t it = 0; it < nj; ++it)
+            {
+                std::copy_n(scratch.data() + it * TILE, ni, lower + static_cast<ssize_t>(it) * ld);
+            }
+        }
+    };
+    detail::transpose_parallel(pairs.size(), n * n, options, work);
+}
+
+} /* end namespace modmesh */
+
+/* vim: set et ts=4 sw=4: */
@@ -33,7 +33,22 @@
  */
 
 #include <modmesh/buffer/small_vector.hpp>
+#include <modmesh/buffer/BufferPool.hpp>
 #include <modmesh/buffer/ConcreteBuffer.hpp>
 #include <modmesh/buffer/SimpleArray.hpp>
+#include <modmesh/buffer/FixedArray.hpp>
+#include <modmesh/buffer/NdIter.hpp>
+#include <modmesh/buffer/SimdDispatch.hpp>
+#include <modmesh/buffer/StridedCopy.hpp>
+#include <modmesh/buffer/Broadcast.hpp>
+#include <modmesh/buffer/ArrayExpression.hpp>
+#include <modmesh/buffer/SimdKernel.hpp>
+#include <modmesh/buffer/Reduction.hpp>
+#include <modmesh/buffer/Transpose.hpp>
+#include <modmesh/buffer/DomainDecomposition.hpp>
+#include <modmesh/buffer/ArrayFile.hpp>
+#include <modmesh/buffer/ChunkedArray.hpp>
+#include <modmesh/buffer/GatherScatter.hpp>
+#include <modmesh/buffer/SimpleCollector.hpp>
 
 // vim: set ff=unix fenc=utf8 et sw=4 ts=4 sts=4:
@@ -31,6 +31,10 @@
 #include <pybind11/pybind11.h> // Must be the first include.
 #include <pybind11/numpy.h>
 #include <modmesh/buffer/SimpleArray.hpp>
+#include <modmesh/buffer/Broadcast.hpp>
+#include <modmesh/buffer/StridedCopy.hpp>
+
+#include <array>
 
 namespace modmesh
 {
@@ -43,71 +47,59 @@ struct TypeBroadcastImpl
     using slice_type = small_vector<int>;
     using shape_type = typename SimpleArray<T>::shape_type;
 
-    // NOLINTNEXTLINE(misc-no-recursion)
-    static void copy_idx(SimpleArray<T> & arr_out, std::vector<slice_type> const & slices, pybind11::array_t<D> const * arr_in, shape_type left_shape, shape_type sidx, int dim)
+    static void broadcast(SimpleArray<T> & arr_out, std::vector<slice_type> const & slices, pybind11::array const & arr_in)
     {
-        using out_type = typename std::remove_reference_t<decltype(arr_out[0])>;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto * arr_new = reinterpret_cast<pybind11::array_t<D> const *>(&arr_in);
 
-        if (dim < 0)
+        size_t const ndim = arr_out.ndim();
+        shape_type left_shape(ndim);
+        small_vector<ssize_t> stride_out(ndim);
+        T * ptr_out = arr_out.data();
+        for (size_t i = 0; i < ndim; ++i)
         {
-            return;
+            slice_type const & slice = slices[i];
+            left_shape[i] = slice_length(slice);
+            ptr_out += static_cast<ssize_t>(arr_out.stride(i)) * slice[0];
+            stride_out[i] = static_cast<ssize_t>(arr_out.stride(i)) * slice[2];
         }
 
-        for (size_t i = 0; i < left_shape[dim]; ++i)
+        // The broadcast dimensions of the input are read with the stride 0.
+        size_t const ndim_in = static_cast<size_t>(arr_new->ndim());
+        shape_type right_shape(ndim_in);
+        small_vector<ssize_t> right_stride(ndim_in);
+        for (size_t i = 0; i < ndim_in; ++i)
         {
-            sidx[dim] = i;
-
-            size_t offset_in = 0;
-            for (pybind11::ssize_t it = 0; it < arr_in->ndim(); ++it)
-            {
-                offset_in += arr_in->strides(it) / arr_in->itemsize() * sidx[it];
-            }
-            const D * ptr_in = arr_in->data() + offset_in;
-
-            size_t offset_out = 0;
-            for (size_t it = 0; it < arr_out.ndim(); ++it)
-            {
-                auto step = slices[it][2];
-                offset_out += arr_out.stride(it) * sidx[it] * step;
-            }
-
-            // NOLINTNEXTLINE(bugprone-signed-char-misuse, cert-str34-c)
-            arr_out.at(offset_out) = static_cast<out_type>(*ptr_in);
-            // recursion here
-            copy_idx(arr_out, slices, arr_in, left_shape, sidx, dim - 1);
+            right_shape[i] = arr_new->shape(static_cast<pybind11::ssize_t>(i));
+            right_stride[i] = arr_new->strides(static_cast<pybind11::ssize_t>(i)) / arr_new->itemsize();
         }
+        small_vector<ssize_t> const stride_in = broadcast_stride(right_shape, right_stride, left_shape);
+
+        strided_copy(ptr_out, stride_out, arr_new->data(), stride_in, left_shape);
     }
 
-    static void broadcast(SimpleArray<T> & arr_out, std::vector<slice_type> const & slices, pybind11::array const & arr_in)
+    static size_t slice_length(slice_type const & slice)
     {
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        auto * arr_new = reinterpret_cast<pybind11::array_t<D> const *>(&arr_in);
-
-        shape_type left_shape(arr_out.ndim());
-        for (size_t i = 0; i < arr_out.ndim(); i++)
+        if (slice[1] <= slice[0])
         {
-            slice_type const & slice = slices[i];
-            if ((slice[1] - slice[0]) % slice[2] == 0)
-            {
-                left_shape[i] = (slice[1] - slice[0]) / slice[2];
-            }
-            else
-            {
-                left_shape[i] = (slice[1] - slice[0]) / slice[2] + 1;
-            }
+            return 0;
         }
-
-        shape_type sidx_init(arr_out.ndim());
-
-        for (size_t i = 0; i < arr_out.ndim(); ++i)
+        if ((slice[1] - slice[0]) % slice[2] == 0)
         {
-            sidx_init[i] = 0;
+            return (slice[1] - slice[0]) / slice[2];
         }
-
-        copy_idx(arr_out, slices, arr_new, left_shape, sidx_init, static_cast<int>(arr_out.ndim()) - 1);
+        return (slice[1] - slice[0]) / slice[2] + 1;
     }
 }; /* end struct TypeBroadcastImpl */
 
+template <typename... Ts>
+struct TypeList
+{
+}; /* end struct TypeList */
+
+// All the element types wrapped for SimpleArray.
+using SourceTypes = TypeList<bool, int8_t, int16_t, int32_t, int64_t, uint8_t, uint16_t, uint32_t, uint64_t, float, double>;
+
 template <typename T>
 struct TypeBroadcast
 {
@@ -123,86 +115,102 @@ struct TypeBroadcast
         }
 
         shape_type left_shape(arr_out.ndim());
-        // TODO: range check
         for (size_t i = 0; i < arr_out.ndim(); i++)
         {
             const slice_type & slice = slices[i];
-            if ((slice[1] - slice[0]) % slice[2] == 0)
+            if (slice[2] <= 0)
             {
-                left_shape[i] = (slice[1] - slice[0]) / slice[2];
+                throw std::runtime_error("slice step must be positive");
             }
-            else
+            left_shape[i] = TypeBroadcastImpl<T, T>::slice_length(slice);
+            // The copy engine does not check bounds; do it here.
+            if (0 != left_shape[i]
+                && (slice[0] < 0 || static_cast<size_t>(slice[0]) + (left_shape[i] - 1) * slice[2] >= arr_out.shape(i)))
             {
-                left_shape[i] = (slice[1] - slice[0]) / slice[2] + 1;
+                std::ostringstream msg;
+                msg << "slice [" << slice[0] << ":" << slice[1] << ":" << slice[2] << "] is out of bounds of dim "
+                    << i << " with shape " << arr_out.shape(i);
+                throw std::out_of_range(msg.str());
             }
         }
 
-        if (arr_out.ndim() != static_cast<size_t>(arr_in.ndim()))
+        if (!is_broadcastable(right_shape, left_shape))
         {
             throw_shape_error(left_shape, right_shape);
         }
-
-        for (size_t i = 0; i < left_shape.size(); ++i)
-        {
-            if (left_shape[i] != static_cast<size_t>(right_shape[i]))
-            {
-                throw_shape_error(left_shape, right_shape);
-            }
-        }
     }
 
     static void broadcast(SimpleArray<T> & arr_out, std::vector<slice_type> const & slices, pybind11::array const & arr_in)
     {
-        if (dtype_is_type<bool>(arr_in))
-        {
-            TypeBroadcastImpl<T, bool>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<int8_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, int8_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<int16_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, int16_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<int32_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, int32_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<int64_t>(arr_in))
+        if (!arr_in.dtype().attr("isnative").cast<bool>())
         {
-            TypeBroadcastImpl<T, int64_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<uint32_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, uint32_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<uint16_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, uint16_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<uint32_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, uint32_t>::broadcast(arr_out, slices, arr_in);
-        }
-        else if (dtype_is_type<uint64_t>(arr_in))
-        {
-            TypeBroadcastImpl<T, uint64_t>::broadcast(arr_out, slices, arr_in);
+            // The kernels copy the bytes as they are, so swap them to the
+            // native order first.  The type number stays the same.
+            pybind11::array const swapped = arr_in.attr("astype")(arr_in.dtype().attr("newbyteorder")("="));
+            broadcast(arr_out, slices, swapped);
+            return;
         }
-        else if (dtype_is_type<float>(arr_in))
+        int const num = pybind11::detail::array_descriptor_proxy(arr_in.dtype().ptr())->type_num;
+        kernel_type const kernel = (num >= 0 && num < NTYPE) ? table()[num] : nullptr;
+        if (nullptr == kernel)
         {
-            TypeBroadcastImpl<T, float>::broadcast(arr_out, slices, arr_in);
+            throw std::runtime_error("input array data type not support!");
         }
-        else if (dtype_is_type<double>(arr_in))
+        kernel(arr_out, slices, arr_in);
+    }
+
+private:
+
+    using kernel_type = void (*)(SimpleArray<T> &, std::vector<slice_type> const &, pybind11::array const &);
+
+    // Number of the builtin NumPy type numbers (NPY_NTYPES_LEGACY).
+    static constexpr int NTYPE = 24;
+
+    /**
+     * The kernel table indexed by the NumPy type number of the source array.
+     * It is filled once by asking which wrapped type each builtin type number
+     * is equivalent to (PyArray_EquivTypes), so that aliases like NPY_LONG
+     * and NPY_LONGLONG both dispatch to int64_t on LP64.
+     */
+    static std::array<kernel_type, NTYPE> const & table()
+    {
+        static std::array<kernel_type, NTYPE> const ret = make_table(SourceTypes{});
+        return ret;
+    }
+
+    template <typename... S>
+    static std::array<kernel_type, NTYPE> make_table(TypeList<S...>)
+    {
+        std::array<kernel_type, NTYPE> ret{};
+        for (int num = 0; num < NTYPE; ++num)
         {
-            TypeBroadcastImpl<T, double>::broadcast(arr_out, slices, arr_in);
+            PyObject * descr = pybind11::detail::npy_api::get().PyArray_DescrFromType_(num);
+            if (nullptr == descr)
+            {
+                PyErr_Clear();
+                continue;
+            }
+            auto const dt = pybind11::reinterpret_steal<pybind11::dtype>(descr);
+            (fill_kernel<S>(ret[num], dt), ...);
         }
-        else
+        return ret;
+    }
+
+    template <typename S>
+    static void fill_kernel(kernel_type & kernel, pybind11::dtype const & dt)
+    {
+        // Keep the first matching type in the list.  The descriptors of the
+        // aliased type numbers are distinct objects, so compare by value.
+        if (nullptr == kernel
+            && pybind11::detail::npy_api::get().PyArray_EquivTypes_(
+                pybind11::detail::npy_format_descriptor<S>::dtype().ptr(), dt.ptr()))
         {
-            throw std::runtime_error("input array data type not support!");
+            kernel = &TypeBroadcastImpl<T, S>::broadcast;
         }
     }
 
+public:
+
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     static void throw_shape_error(shape_type const & left_shape, shape_type const & right_shape)
     {
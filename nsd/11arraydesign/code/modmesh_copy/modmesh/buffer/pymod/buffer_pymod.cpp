@@ -43,6 +43,44 @@ OneTimeInitializer<buffer_pymod_tag> & OneTimeInitializer<buffer_pymod_tag>::me(
     return instance;
 }
 
+BufferAlignment make_buffer_alignment(size_t alignment)
+{
+    switch (alignment)
+    {
+    case 0:
+        return BufferAlignment::DEFAULT;
+    case 16:
+        return BufferAlignment::A16;
+    case 32:
+        return BufferAlignment::A32;
+    case 64:
+        return BufferAlignment::A64;
+    case 4096:
+        return BufferAlignment::PAGE;
+    case 2097152:
+        return BufferAlignment::HUGEPAGE;
+    default:
+        std::ostringstream ms;
+        ms << "alignment " << alignment << " is not one of 0, 16, 32, 64, 4096, 2097152";
+        throw std::invalid_argument(ms.str());
+    }
+}
+
+ArrayLayout make_array_layout(std::string const & order)
+{
+    if ("C" == order)
+    {
+        return ArrayLayout::C;
+    }
+    if ("F" == order)
+    {
+        return ArrayLayout::F;
+    }
+    std::ostringstream ms;
+    ms << "order \"" << order << "\" is not one of \"C\", \"F\"";
+    throw std::invalid_argument(ms.str());
+}
+
 void initialize_buffer(pybind11::module & mod)
 {
     auto initialize_impl = [](pybind11::module & mod)
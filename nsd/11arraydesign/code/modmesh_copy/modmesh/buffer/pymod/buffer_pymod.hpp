@@ -43,6 +43,12 @@ void initialize_buffer(pybind11::module & mod);
 void wrap_ConcreteBuffer(pybind11::module & mod);
 void wrap_SimpleArray(pybind11::module & mod);
 
+/// Convert the alignment in bytes taken from Python to the buffer policy.
+BufferAlignment make_buffer_alignment(size_t alignment);
+
+/// Convert the NumPy-style order "C" or "F" taken from Python to the layout.
+ArrayLayout make_array_layout(std::string const & order);
+
 } /* end namespace python */
 
 } /* end namespace modmesh */
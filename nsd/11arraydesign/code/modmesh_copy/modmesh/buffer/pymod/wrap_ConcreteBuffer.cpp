@@ -43,6 +43,48 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapConcreteBuffer
 
     WrapConcreteBuffer(pybind11::module & mod, char const * pyname, char const * pydoc);
 
+    static BufferMapMode make_map_mode(std::string const & mode)
+    {
+        if ("r" == mode)
+        {
+            return BufferMapMode::READ;
+        }
+        if ("r+" == mode)
+        {
+            return BufferMapMode::READWRITE;
+        }
+        if ("w+" == mode)
+        {
+            return BufferMapMode::CREATE;
+        }
+        if ("c" == mode)
+        {
+            return BufferMapMode::COPY;
+        }
+        throw std::invalid_argument("ConcreteBuffer: mmap mode must be one of \"r\", \"r+\", \"w+\", \"c\"");
+    }
+
+    static BufferMapAdvice make_map_advice(std::string const & advice)
+    {
+        if ("normal" == advice)
+        {
+            return BufferMapAdvice::NORMAL;
+        }
+        if ("sequential" == advice)
+        {
+            return BufferMapAdvice::SEQUENTIAL;
+        }
+        if ("random" == advice)
+        {
+            return BufferMapAdvice::RANDOM;
+        }
+        if ("willneed" == advice)
+        {
+            return BufferMapAdvice::WILLNEED;
+        }
+        throw std::invalid_argument("ConcreteBuffer: mmap advice must be one of \"normal\", \"sequential\", \"random\", \"willneed\"");
+    }
+
 }; /* end class WrapConcreteBuffer */
 
 WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyname, char const * pydoc)
@@ -53,9 +95,10 @@ WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyna
     (*this)
         .def_timed(
             py::init(
-                [](size_t nbytes)
-                { return wrapped_type::construct(nbytes); }),
-            py::arg("nbytes"))
+                [](size_t nbytes, size_t alignment)
+                { return wrapped_type::construct(nbytes, make_buffer_alignment(alignment)); }),
+            py::arg("nbytes"),
+            py::arg("alignment") = 0)
         .def(
             py::init(
                 [](py::array & arr_in)
@@ -64,8 +107,51 @@ WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyna
                         arr_in.nbytes(), arr_in.mutable_data(), std::make_unique<ConcreteBufferNdarrayRemover>(arr_in));
                 }),
             py::arg("array"))
+        .def_static(
+            "mmap",
+            [](std::string const & path, std::string const & mode, size_t nbytes, size_t offset, std::string const & advice)
+            {
+                return wrapped_type::construct_mmap(path, make_map_mode(mode), nbytes, offset, make_map_advice(advice));
+            },
+            py::arg("path"),
+            py::arg("mode") = "r",
+            py::arg("nbytes") = 0,
+            py::arg("offset") = 0,
+            py::arg("advice") = "normal")
+        .def_static(
+            "shm",
+            [](size_t nbytes, std::string const & name)
+            { return wrapped_type::construct_shm(nbytes, name); },
+            py::arg("nbytes"),
+            py::arg("name") = "")
+        .def_static("shm_attach", &wrapped_type::attach_shm, py::arg("name"), py::arg("adopt") = false)
+        .def_static("shm_unlink", &wrapped_type::unlink_shm, py::arg("name"))
+        .def_property_readonly("shm_name", &wrapped_type::shm_name)
+        .def(
+            "__reduce__",
+            [](wrapped_type & self)
+            {
+                // A shared-memory buffer pickles to its name, so that a worker process
+                // attaches to the same memory.  The pickle holds a reference, which the
+                // receiver adopts, so that the sender may drop the buffer before the
+                // receiver attaches.  Load each pickle once, or the segment is left
+                // behind.
+                std::string name = self.shm_name();
+                if (name.empty())
+                {
+                    throw py::type_error("ConcreteBuffer: only a shared-memory buffer can be pickled");
+                }
+                self.retain_shm();
+                py::object cls = py::cast(self.shared_from_this()).attr("__class__");
+                return py::make_tuple(cls.attr("shm_attach"), py::make_tuple(name, true));
+            })
         .def_timed("clone", &wrapped_type::clone)
         .def_property_readonly("nbytes", &wrapped_type::nbytes)
+        .def_property_readonly(
+            "alignment",
+            [](wrapped_type const & self)
+            { return static_cast<size_t>(self.alignment()); })
+        .def("is_aligned", &wrapped_type::is_aligned, py::arg("bytes"))
         .def("__len__", &wrapped_type::size)
         .def(
             "__getitem__",
@@ -74,7 +160,11 @@ WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyna
         .def(
             "__setitem__",
             [](wrapped_type & self, size_t it, int8_t val)
-            { self.at(it) = val; })
+            {
+                self.validate_writable();
+                self.at(it) = val;
+            })
+        .def_property_readonly("readonly", &wrapped_type::readonly)
         .def_buffer(
             [](wrapped_type & self)
             {
@@ -84,7 +174,8 @@ WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyna
                     py::format_descriptor<int8_t>::format(), /* Python struct-style format descriptor */
                     1, /* Number of dimensions */
                     {self.size()}, /* Buffer dimensions */
-                    {1} /* Strides (in bytes) for each index */
+                    {1}, /* Strides (in bytes) for each index */
+                    self.readonly() /* Read-only for a file mapped with mode "r" */
                 );
             })
         .def_property_readonly(
@@ -92,13 +183,18 @@ WrapConcreteBuffer::WrapConcreteBuffer(pybind11::module & mod, char const * pyna
             [](wrapped_type & self)
             {
                 namespace py = pybind11;
-                return py::array(
+                py::array ret(
                     py::detail::npy_format_descriptor<int8_t>::dtype(), /* Numpy dtype */
                     {self.size()}, /* Buffer dimensions */
                     {1}, /* Strides (in bytes) for each index */
                     self.data(), /* Pointer to buffer */
                     py::cast(self.shared_from_this()) /* Owning Python object */
                 );
+                if (self.readonly())
+                {
+                    ret.attr("setflags")(py::arg("write") = false);
+                }
+                return ret;
             })
         .def_property_readonly(
             "is_from_python",
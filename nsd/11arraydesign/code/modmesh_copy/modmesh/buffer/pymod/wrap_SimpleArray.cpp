@@ -56,9 +56,17 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapSimpleArray
         (*this)
             .def_timed(
                 py::init(
-                    [](py::object const & shape)
-                    { return wrapped_type(make_shape(shape)); }),
-                py::arg("shape"))
+                    [](py::object const & shape, size_t alignment, std::string const & order)
+                    { return wrapped_type(make_shape(shape), make_array_layout(order), make_buffer_alignment(alignment)); }),
+                py::arg("shape"),
+                py::arg("alignment") = 0,
+                py::arg("order") = "C")
+            .def(
+                py::init(
+                    [](py::object const & shape, std::shared_ptr<ConcreteBuffer> const & buffer)
+                    { return wrapped_type(make_shape(shape), buffer); }),
+                py::arg("shape"),
+                py::arg("buffer"))
             .def(
                 py::init(
                     [](py::array & arr_in)
@@ -67,16 +75,9 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapSimpleArray
                         {
                             throw std::runtime_error("dtype mismatch");
                         }
-                        shape_type shape;
-                        for (ssize_t i = 0; i < arr_in.ndim(); ++i)
-                        {
-                            shape.push_back(arr_in.shape(i));
-                        }
-                        std::shared_ptr<ConcreteBuffer> const buffer = ConcreteBuffer::construct(
-                            arr_in.nbytes(),
-                            arr_in.mutable_data(),
-                            std::make_unique<ConcreteBufferNdarrayRemover>(arr_in));
-                        return wrapped_type(shape, buffer);
+                        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                        auto * arr_typed = reinterpret_cast<py::array_t<T> *>(&arr_in);
+                        return makeSimpleArray(*arr_typed);
                     }),
                 py::arg("array"))
             .def_buffer(
@@ -87,13 +88,18 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapSimpleArray
                     {
                         stride.push_back(i * sizeof(T));
                     }
+                    // The Python buffer writes to the memory like a view: buffer()
+                    // detaches a copy-on-write array and marks it as aliased.
+                    // Query the flag after it.
+                    T * const data = self.buffer().template data<T>();
                     return py::buffer_info(
-                        self.data(), /* Pointer to buffer */
+                        data, /* Pointer to buffer */
                         sizeof(T), /* Size of one scalar */
                         py::format_descriptor<T>::format(), /* Python struct-style format descriptor */
                         self.ndim(), /* Number of dimensions */
                         std::vector<size_t>(self.shape().begin(), self.shape().end()), /* Buffer dimensions */
-                        stride /* Strides (in bytes) for each index */
+                        stride, /* Strides (in bytes) for each index */
+                        std::as_const(self).buffer().readonly() /* Read-only for a file mapped with mode "r" */
                     );
                 })
             .def_property_readonly(
@@ -109,6 +115,10 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapSimpleArray
             .def_property_readonly("nbytes", &wrapped_type::nbytes)
             .def_property_readonly("size", &wrapped_type::size)
             .def_property_readonly("itemsize", &wrapped_type::itemsize)
+            .def_property_readonly(
+                "alignment",
+                [](wrapped_type const & self)
+                { return static_cast<size_t>(self.alignment()); })
             .def_property_readonly(
                 "shape",
                 [](wrapped_type const & self)
@@ -140,22 +150,217 @@ class MODMESH_PYTHON_WRAPPER_VISIBILITY WrapSimpleArray
                 "__getitem__",
                 [](wrapped_type const & self, std::vector<ssize_t> const & key)
                 { return self.at(key); })
+            .def(
+                "__getitem__",
+                [](wrapped_type const & self, py::slice const & key)
+                { return getitem_view(self, py::make_tuple(key)); })
+            .def(
+                "__getitem__",
+                [](wrapped_type const & self, py::ellipsis const & key)
+                { return getitem_view(self, py::make_tuple(key)); })
+            .def(
+                "__getitem__",
+                [](wrapped_type const & self, py::tuple const & key)
+                { return getitem_view(self, key); })
             .def("__setitem__", &setitem_parser)
             .def(
                 "reshape",
                 [](wrapped_type const & self, py::object const & shape)
                 { return self.reshape(make_shape(shape)); })
+            .def(
+                "transpose",
+                [](wrapped_type const & self, size_t nthread)
+                {
+                    TransposeOptions options;
+                    options.nthread = nthread;
+                    return transpose(self, options);
+                },
+                py::arg("nthread") = 0)
+            .def(
+                "permute",
+                [](wrapped_type const & self, py::object const & axes, size_t nthread)
+                {
+                    TransposeOptions options;
+                    options.nthread = nthread;
+                    return permute(self, make_shape(axes), options);
+                },
+                py::arg("axes"),
+                py::arg("nthread") = 0)
+            .def_property_readonly("is_c_contiguous", &wrapped_type::is_c_contiguous)
+            .def_property_readonly("is_f_contiguous", &wrapped_type::is_f_contiguous)
             .def_property_readonly("has_ghost", &wrapped_type::has_ghost)
             .def_property("nghost", &wrapped_type::nghost, &wrapped_type::set_nghost)
             .def_property_readonly("nbody", &wrapped_type::nbody)
+            .def_property("copy_on_write", &wrapped_type::copy_on_write, &wrapped_type::set_copy_on_write)
+            .def_property_readonly("is_shared", &wrapped_type::is_shared)
             //
             ;
+
+        def_gather_scatter<int32_t>();
+        def_gather_scatter<int64_t>();
+    }
+
+    /// Define take, put and scatter_add with the indices in SimpleArray<I>.
+    template <typename I>
+    void def_gather_scatter()
+    {
+        namespace py = pybind11;
+
+        (*this)
+            .def(
+                "take",
+                [](wrapped_type const & self, SimpleArray<I> const & indices, size_t nthread)
+                {
+                    GatherScatterOptions options;
+                    options.nthread = nthread;
+                    return take(self, indices, options);
+                },
+                py::arg("indices"),
+                py::arg("nthread") = 0)
+            .def(
+                "put",
+                [](wrapped_type & self, SimpleArray<I> const & indices, wrapped_type const & values, size_t nthread)
+                {
+                    GatherScatterOptions options;
+                    options.nthread = nthread;
+                    put(self, indices, values, options);
+                },
+                py::arg("indices"),
+                py::arg("values"),
+                py::arg("nthread") = 0)
+            //
+            ;
+        if constexpr (!std::is_same_v<T, bool>)
+        {
+            (*this)
+                .def(
+                    "scatter_add",
+                    [](wrapped_type & self, SimpleArray<I> const & indices, wrapped_type const & values, size_t nthread)
+                    {
+                        GatherScatterOptions options;
+                        options.nthread = nthread;
+                        scatter_add(self, indices, values, options);
+                    },
+                    py::arg("indices"),
+                    py::arg("values"),
+                    py::arg("nthread") = 0);
+        }
+    }
+
+    /**
+     * Take a view for a key of slices, integers and at most one ellipsis.  An
+     * integer selects one index and drops the dimension like NumPy.  Negative
+     * steps are not supported since the strides of SimpleArray are unsigned.
+     *
+     * The indices count like at() for every key type: the first dimension
+     * from the body, so that -nghost to -1 are the ghost cells, and the
+     * others from 0.  Negative indices are not counted from the end.  A slice
+     * without start or stop takes the whole dimension including the ghost
+     * cells, and a stop past the end is clipped like in Python.
+     */
+    static wrapped_type getitem_view(wrapped_type const & self, pybind11::tuple const & key)
+    {
+        namespace py = pybind11;
+
+        size_t nellipsis = 0;
+        for (auto const & item : key)
+        {
+            if (py::isinstance<py::ellipsis>(item))
+            {
+                ++nellipsis;
+            }
+            else if (!py::isinstance<py::slice>(item) && !py::isinstance<py::int_>(item))
+            {
+                throw std::runtime_error("unsupported operation.");
+            }
+        }
+        if (nellipsis > 1)
+        {
+            throw std::runtime_error("syntax error. no more than one ellipsis.");
+        }
+        if (key.size() - nellipsis > self.ndim())
+        {
+            throw std::runtime_error("syntax error. dimensions mismatches");
+        }
+
+        std::vector<SimpleSlice> slices(self.ndim());
+        for (size_t i = 0; i < self.ndim(); ++i)
+        {
+            slices[i] = SimpleSlice{0, self.shape(i), 1};
+        }
+        std::vector<bool> drop(self.ndim(), false);
+        auto fill = [&](py::handle const & item, size_t dim)
+        {
+            // The index of the first element in the dimension and the end.
+            ssize_t const lower = 0 == dim ? -static_cast<ssize_t>(self.nghost()) : 0;
+            ssize_t const upper = static_cast<ssize_t>(self.shape(dim)) + lower;
+            if (py::isinstance<py::int_>(item))
+            {
+                auto const idx = item.cast<ssize_t>();
+                if (idx < lower || idx >= upper)
+                {
+                    std::ostringstream ms;
+                    ms << "SimpleArray: index " << idx << " out of range [" << lower << ", " << upper << ") of dim " << dim;
+                    throw py::index_error(ms.str());
+                }
+                size_t const pos = static_cast<size_t>(idx - lower);
+                slices[dim] = SimpleSlice{pos, pos + 1, 1};
+                drop[dim] = true;
+                return;
+            }
+            auto const slice = item.cast<py::slice>();
+            auto bound = [&](py::object const & value, ssize_t none, char const * name)
+            {
+                if (value.is_none())
+                {
+                    return none;
+                }
+                auto const idx = value.cast<ssize_t>();
+                if (idx < lower)
+                {
+                    std::ostringstream ms;
+                    ms << "SimpleArray: slice " << name << " " << idx << " < " << lower << " of dim " << dim;
+                    throw py::index_error(ms.str());
+                }
+                return std::min(idx, upper);
+            };
+            ssize_t const step = slice.attr("step").is_none() ? 1 : slice.attr("step").cast<ssize_t>();
+            if (step <= 0)
+            {
+                throw std::runtime_error("SimpleArray: slice step must be positive");
+            }
+            ssize_t const start = bound(slice.attr("start"), lower, "start");
+            ssize_t const stop = std::max(start, bound(slice.attr("stop"), upper, "stop"));
+            slices[dim] = SimpleSlice{static_cast<size_t>(start - lower), static_cast<size_t>(stop - lower), static_cast<size_t>(step)};
+        };
+
+        // Fill from the front until the ellipsis and then from the back.
+        size_t ifront = 0;
+        for (; ifront < key.size() && !py::isinstance<py::ellipsis>(key[ifront]); ++ifront)
+        {
+            fill(key[ifront], ifront);
+        }
+        for (size_t iback = 1; ifront < key.size() && iback < key.size() - ifront; ++iback)
+        {
+            fill(key[key.size() - iback], self.ndim() - iback);
+        }
+
+        // Both views are taken from const arrays, so that they share the
+        // memory and keep the copy-on-write flag.
+        wrapped_type ret = self.view(slices);
+        if (std::find(drop.begin(), drop.end(), true) == drop.end())
+        {
+            return ret;
+        }
+        return std::as_const(ret).squeeze(drop);
     }
 
     static void setitem_parser(wrapped_type & arr_out, pybind11::args const & args)
     {
         namespace py = pybind11;
 
+        std::as_const(arr_out).buffer().validate_writable();
+
         if (args.size() == 2)
         {
             // sarr[K] = V
@@ -28,10 +28,22 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <stdexcept>
+/**
+ * A vector keeping up to N elements in place, for the shapes and strides of
+ * arrays.  The storage is raw memory; the elements are constructed in place
+ * only when they are added, and the trivially copyable ones are copied and
+ * moved with memcpy.  Growing past N moves the elements to the heap.
+ */
+
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <algorithm>
 
 namespace modmesh
 {
@@ -46,173 +58,109 @@ public:
     using iterator = T *;
     using const_iterator = T const *;
 
+    static_assert(N > 0, "small_vector needs an inline capacity");
+
+    /// Number of elements kept without heap allocation.
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    small_vector() noexcept
+        : m_head(inline_data())
+    {
+    }
+
+    /// Construct size elements; a trivial type is left uninitialized.
     explicit small_vector(size_t size)
-        : m_size(static_cast<unsigned int>(size))
+        : small_vector()
     {
-        if (m_size > N)
-        {
-            m_capacity = m_size;
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            m_head = new T[m_capacity];
-        }
-        else
-        {
-            m_capacity = N;
-            m_head = m_data.data();
-        }
+        grow_empty(size);
+        std::uninitialized_default_construct_n(m_head, size);
+        m_size = static_cast<unsigned int>(size);
     }
 
     explicit small_vector(size_t size, T const & v)
-        : small_vector(size)
+        : small_vector()
     {
-        std::fill(begin(), end(), v);
+        grow_empty(size);
+        std::uninitialized_fill_n(m_head, size, v);
+        m_size = static_cast<unsigned int>(size);
     }
 
     explicit small_vector(std::vector<T> const & vector)
-        : small_vector(vector.size())
+        : small_vector()
     {
-        std::copy_n(vector.begin(), m_size, begin());
+        assign_range(vector.data(), vector.size());
     }
 
     template <class InputIt>
     small_vector(InputIt first, InputIt last)
-        : small_vector(last - first)
+        : small_vector()
     {
-        std::copy(first, last, begin());
+        size_t const size = static_cast<size_t>(std::distance(first, last));
+        grow_empty(size);
+        std::uninitialized_copy(first, last, m_head);
+        m_size = static_cast<unsigned int>(size);
     }
 
     small_vector(std::initializer_list<T> init)
-        : small_vector(init.size())
+        : small_vector()
     {
-        std::copy_n(init.begin(), m_size, begin());
+        assign_range(init.begin(), init.size());
     }
 
-    small_vector() { m_head = m_data.data(); }
-
     small_vector(small_vector const & other)
-        : m_size(other.m_size)
+        : small_vector()
     {
-        if (other.m_head == other.m_data.data())
-        {
-            m_capacity = N;
-            m_head = m_data.data();
-        }
-        else
-        {
-            m_capacity = m_size;
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            m_head = new T[m_capacity];
-        }
-        std::copy_n(other.m_head, m_size, m_head);
+        assign_range(other.m_head, other.m_size);
+    }
+
+    /// Copy from a small_vector of another inline capacity.
+    template <size_t M>
+    // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+    small_vector(small_vector<T, M> const & other)
+        : small_vector()
+    {
+        assign_range(other.data(), other.size());
     }
 
     small_vector(small_vector && other) noexcept
-        : m_size(other.m_size)
+        : small_vector()
     {
-        if (other.m_head == other.m_data.data())
-        {
-            m_capacity = N;
-            std::copy_n(other.m_data.begin(), m_size, m_data.begin());
-            m_head = m_data.data();
-        }
-        else
-        {
-            m_capacity = m_size;
-            m_head = other.m_head;
-            other.m_size = 0;
-            other.m_capacity = N;
-            other.m_head = other.m_data.data();
-        }
+        steal(other);
     }
 
     small_vector & operator=(small_vector const & other)
     {
         if (this != &other)
         {
-            if (other.m_head == other.m_data.data())
-            {
-                if (m_head != m_data.data())
-                {
-                    delete[] m_head;
-                    m_head = m_data.data();
-                }
-                m_size = other.m_size;
-                m_capacity = N;
-            }
-            else
-            {
-                if (m_capacity < other.m_size)
-                {
-                    delete[] m_head;
-                    m_head = nullptr;
-                }
-                if (m_head == m_data.data() || m_head == nullptr)
-                {
-                    m_capacity = other.m_size;
-                    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-                    m_head = new T[m_capacity];
-                }
-                m_size = other.m_size;
-            }
-            std::copy_n(other.m_head, m_size, m_head);
+            assign_range(other.m_head, other.m_size);
         }
         return *this;
     }
 
+    template <size_t M>
+    small_vector & operator=(small_vector<T, M> const & other)
+    {
+        assign_range(other.data(), other.size());
+        return *this;
+    }
+
     small_vector & operator=(small_vector && other) noexcept
     {
         if (this != &other)
         {
-            if (other.m_head == other.m_data.data())
-            {
-                if (m_head != m_data.data())
-                {
-                    delete[] m_head;
-                    m_head = m_data.data();
-                }
-                m_size = other.m_size;
-                m_capacity = N;
-                std::copy_n(other.m_data.begin(), m_size, m_data.begin());
-            }
-            else
-            {
-                m_size = other.m_size;
-                m_capacity = other.m_capacity;
-                m_head = other.m_head;
-                other.m_size = 0;
-                other.m_capacity = N;
-                other.m_head = other.m_data.data();
-            }
+            clear();
+            steal(other);
         }
         return *this;
     }
 
     small_vector & operator=(std::vector<T> const & other)
     {
-        if (size() < other.size())
-        {
-            std::copy(other.begin(), other.begin() + size(), begin());
-            for (size_t it = size(); it < other.size(); ++it)
-            {
-                push_back(other[it]);
-            }
-        }
-        else
-        {
-            std::copy(other.begin(), other.end(), begin());
-            m_size = static_cast<unsigned int>(other.size());
-        }
+        assign_range(other.data(), other.size());
         return *this;
     }
 
-    ~small_vector()
-    {
-        if (m_head != m_data.data() && m_head != nullptr)
-        {
-            delete[] m_head;
-            m_head = nullptr;
-        }
-    }
+    ~small_vector() { clear(); }
 
     size_t size() const noexcept { return m_size; }
     size_t capacity() const noexcept { return m_capacity; }
@@ -239,39 +187,100 @@ public:
         return (*this)[it];
     }
 
+    T const & front() const { return m_head[0]; }
+    T & front() { return m_head[0]; }
+    T const & back() const { return m_head[m_size - 1]; }
+    T & back() { return m_head[m_size - 1]; }
+
     T const * data() const { return m_head; }
     T * data() { return m_head; }
 
+    /// Destroy the elements and return the heap storage, if any.
     void clear() noexcept
     {
-        if (m_head != m_data.data())
+        std::destroy_n(m_head, m_size);
+        m_size = 0;
+        if (!is_inline())
         {
-            delete[] m_head;
-            m_head = m_data.data();
+            std::allocator<T>().deallocate(m_head, m_capacity);
+            m_head = inline_data();
+            m_capacity = N;
         }
-        m_size = 0;
-        m_capacity = N;
     }
 
-    void push_back(T const & value)
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            T * storage = std::allocator<T>().allocate(capacity);
+            relocate(storage);
+            m_capacity = static_cast<unsigned int>(capacity);
+        }
+    }
+
+    /// Resize to size elements; the added ones are value-initialized.
+    void resize(size_t size)
+    {
+        if (size > m_size)
+        {
+            reserve(size);
+            std::uninitialized_value_construct_n(m_head + m_size, size - m_size);
+        }
+        else
+        {
+            std::destroy_n(m_head + size, m_size - size);
+        }
+        m_size = static_cast<unsigned int>(size);
+    }
+
+    void resize(size_t size, T const & value)
+    {
+        if (size > m_size)
+        {
+            reserve(size);
+            std::uninitialized_fill_n(m_head + m_size, size - m_size, value);
+        }
+        else
+        {
+            std::destroy_n(m_head + size, m_size - size);
+        }
+        m_size = static_cast<unsigned int>(size);
+    }
+
+    template <typename... Args>
+    T & emplace_back(Args &&... args)
     {
         if (m_size == m_capacity)
         {
-            m_capacity *= 2;
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            T * storage = new T[m_capacity];
-            std::copy_n(m_head, m_size, storage);
-            if (m_head != m_data.data())
-            {
-                delete[] m_head;
-            }
-            m_head = storage;
+            // Construct the new element before the old ones move; args may refer to them.
+            size_t const capacity = 2 * static_cast<size_t>(m_capacity);
+            T * storage = std::allocator<T>().allocate(capacity);
+            ::new (static_cast<void *>(storage + m_size)) T(std::forward<Args>(args)...);
+            relocate(storage);
+            m_capacity = static_cast<unsigned int>(capacity);
+        }
+        else
+        {
+            ::new (static_cast<void *>(m_head + m_size)) T(std::forward<Args>(args)...);
         }
-        m_head[m_size++] = value;
+        return m_head[m_size++];
+    }
+
+    void push_back(T const & value) { emplace_back(value); }
+    void push_back(T && value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        --m_size;
+        std::destroy_at(m_head + m_size);
     }
 
 private:
 
+    T * inline_data() noexcept { return std::launder(reinterpret_cast<T *>(m_data.data())); }
+    T const * inline_data() const noexcept { return std::launder(reinterpret_cast<T const *>(m_data.data())); }
+    bool is_inline() const noexcept { return m_head == inline_data(); }
+
     void validate_range(size_t it) const
     {
         if (it >= size())
@@ -280,17 +289,100 @@ private:
         }
     }
 
+    /// Make room for size elements in an empty vector.
+    void grow_empty(size_t size)
+    {
+        if (size > m_capacity)
+        {
+            m_head = std::allocator<T>().allocate(size);
+            m_capacity = static_cast<unsigned int>(size);
+        }
+    }
+
+    /// Move the elements into the heap storage and release the old one.
+    void relocate(T * storage)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (0 != m_size)
+            {
+                std::memcpy(static_cast<void *>(storage), m_head, m_size * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_move_n(m_head, m_size, storage);
+            std::destroy_n(m_head, m_size);
+        }
+        if (!is_inline())
+        {
+            std::allocator<T>().deallocate(m_head, m_capacity);
+        }
+        m_head = storage;
+    }
+
+    /// Replace the elements with copies of the size elements at src.
+    void assign_range(T const * src, size_t size)
+    {
+        std::destroy_n(m_head, m_size);
+        m_size = 0;
+        if (size > m_capacity)
+        {
+            clear();
+            grow_empty(size);
+        }
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (0 != size)
+            {
+                std::memcpy(static_cast<void *>(m_head), src, size * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_copy_n(src, size, m_head);
+        }
+        m_size = static_cast<unsigned int>(size);
+    }
+
+    /// Take the elements of other, which is left empty.
+    void steal(small_vector & other) noexcept
+    {
+        if (other.is_inline())
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(static_cast<void *>(m_head), other.m_head, other.m_size * sizeof(T));
+            }
+            else
+            {
+                std::uninitialized_move_n(other.m_head, other.m_size, m_head);
+            }
+            m_size = other.m_size;
+            other.clear();
+        }
+        else
+        {
+            m_head = other.m_head;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_head = other.inline_data();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+    }
+
     T * m_head = nullptr;
     unsigned int m_size = 0;
     unsigned int m_capacity = N;
-    std::array<T, N> m_data;
+    alignas(T) std::array<unsigned char, N * sizeof(T)> m_data;
 
 }; /* end class small_vector */
 
-template <typename T>
-bool operator==(small_vector<T> const & lhs, small_vector<T> const & rhs)
+template <typename T, size_t N, size_t M>
+bool operator==(small_vector<T, N> const & lhs, small_vector<T, M> const & rhs)
 {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
 static_assert(sizeof(small_vector<size_t>) == 40, "small_vector<size_t> should use 40 bytes");
@@ -196,7 +196,7 @@ std::enable_if_t<is_simple_array_v<S>, pybind11::array> to_ndarray(S && sarr)
     std::vector<size_t> const shape(sarr.shape().begin(), sarr.shape().end());
     std::vector<size_t> stride(sarr.stride().begin(), sarr.stride().end());
     for (size_t & v : stride) { v *= sarr.itemsize(); }
-    return py::array(
+    py::array ret(
         py::detail::npy_format_descriptor<T>::dtype() /* Numpy dtype */
         ,
         shape /* Buffer dimensions */
@@ -207,19 +207,63 @@ std::enable_if_t<is_simple_array_v<S>, pybind11::array> to_ndarray(S && sarr)
         ,
         py::cast(sarr.buffer().shared_from_this()) /* Owning Python object */
     );
+    if (sarr.buffer().readonly())
+    {
+        // Writing through the ndarray would fault on a read-only mapping.
+        ret.attr("setflags")(py::arg("write") = false);
+    }
+    return ret;
 }
 
+/**
+ * Wrap the ndarray without copying.  The NumPy strides are kept, so that
+ * Fortran-ordered and sliced arrays are viewed in place.  Negative strides
+ * and strides not in whole elements cannot be expressed by SimpleArray and
+ * the array is copied to the C order.
+ */
 template <typename T>
 static SimpleArray<T> makeSimpleArray(pybind11::array_t<T> & ndarr)
 {
-    typename SimpleArray<T>::shape_type shape;
+    using shape_type = typename SimpleArray<T>::shape_type;
+    shape_type shape;
+    shape_type stride;
+    bool expressible = true;
     for (ssize_t i = 0; i < ndarr.ndim(); ++i)
     {
         shape.push_back(ndarr.shape(i));
+        ssize_t const bstride = ndarr.strides(i);
+        if (bstride < 0 || 0 != bstride % static_cast<ssize_t>(sizeof(T)))
+        {
+            expressible = false;
+        }
+        stride.push_back(static_cast<size_t>(bstride) / sizeof(T));
+    }
+    if (!expressible)
+    {
+        auto contiguous = pybind11::reinterpret_borrow<pybind11::array_t<T>>(
+            pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>::ensure(ndarr));
+        return makeSimpleArray(contiguous);
     }
+    size_t const nbytes = SimpleArray<T>::calc_span(shape, stride) * sizeof(T);
     std::shared_ptr<ConcreteBuffer> const buffer = ConcreteBuffer::construct(
-        ndarr.nbytes(), ndarr.mutable_data(), std::make_unique<ConcreteBufferNdarrayRemover>(ndarr));
-    return SimpleArray<T>(shape, buffer);
+        nbytes, ndarr.mutable_data(), std::make_unique<ConcreteBufferNdarrayRemover>(ndarr));
+    return SimpleArray<T>(shape, stride, buffer);
+}
+
+/**
+ * Wrap the ndarray without copying when it is C-contiguous.  Otherwise copy
+ * it to the C order.  It is for the kernels using the flat accessors.
+ */
+template <typename T>
+static SimpleArray<T> makeContiguousSimpleArray(pybind11::array_t<T> & ndarr)
+{
+    if (ndarr.flags() & pybind11::array::c_style)
+    {
+        return makeSimpleArray(ndarr);
+    }
+    auto contiguous = pybind11::reinterpret_borrow<pybind11::array_t<T>>(
+        pybind11::array_t<T, pybind11::array::c_style | pybind11::array::forcecast>::ensure(ndarr));
+    return makeSimpleArray(contiguous);
 }
 
 #if defined(_MSC_VER)